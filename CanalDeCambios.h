@@ -0,0 +1,280 @@
+#ifndef CANAL_DE_CAMBIOS_H_
+#define CANAL_DE_CAMBIOS_H_
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <new>
+using namespace std;
+
+/**
+ * Tipos de cambio que informan los contenedores.
+ *
+ * CAMBIO_RESINCRONIZAR marca un hueco en la secuencia: se perdieron cambios
+ * porque el canal estaba lleno (valor dice cuántos) o hubo un cambio que el
+ * canal no describe (grupos, plazos, transferencias, arcos, ...). La copia
+ * del consumidor deja de valer en ese punto, y lo único que puede seguir
+ * hasta el próximo CAMBIO_FOTO son otras marcas.
+ *
+ * CAMBIO_FOTO empieza una foto que manda el productor desde su hilo: la
+ * copia se vacía y los cambios que siguen la vuelven a armar (valor es la
+ * cantidad de elementos). Después de la foto siguen los cambios de siempre.
+ * El consumidor nunca lee el contenedor: lo único que comparten es el canal.
+ */
+enum TipoDeCambio {
+	CAMBIO_AGREGAR,
+	CAMBIO_ELIMINAR,
+	CAMBIO_PAUSAR,
+	CAMBIO_REANUDAR,
+	CAMBIO_EJECUTAR,
+	CAMBIO_DETENER,
+	CAMBIO_REANUDAR_TODO,
+	CAMBIO_FRENAR,
+	CAMBIO_LIBERAR,
+	CAMBIO_MAZO_ROJO,
+	CAMBIO_MAZO_AZUL,
+	CAMBIO_PUNTOS,
+	CAMBIO_RESINCRONIZAR,
+	CAMBIO_FOTO
+};
+
+/**
+ * Un cambio: el tipo, el T afectado (si hay uno) y un número cuyo sentido
+ * depende del tipo (grupo al agregar, lugares que avanza un mazo, puntos
+ * sumados).
+ *
+ * Se puede asumir que el tipo T tiene constructor por copia y operator==
+ * No se puede asumir que el tipo T tenga operator=
+ */
+template<typename T>
+class Cambio {
+
+  public:
+
+	Cambio(TipoDeCambio t, long v) : tipo(t), valor(v), conSujeto(false) {}
+
+	Cambio(TipoDeCambio t, const T& s, long v) : tipo(t), valor(v), conSujeto(true) {
+		new (lugar) T(s);
+	}
+
+	Cambio(const Cambio<T>& otro) : tipo(otro.tipo), valor(otro.valor), conSujeto(otro.conSujeto) {
+		if(conSujeto){
+			new (lugar) T(otro.sujeto());
+		}
+	}
+
+	~Cambio() {
+		if(conSujeto){
+			reinterpret_cast<T*>(lugar)->~T();
+		}
+	}
+
+	bool tieneSujeto() const { return conSujeto; }
+
+	/**
+	 * PRE: tieneSujeto()
+	 */
+	const T& sujeto() const {
+		assert(conSujeto);
+		return *reinterpret_cast<const T*>(lugar);
+	}
+
+	TipoDeCambio tipo;
+	long valor;
+
+  private:
+
+	Cambio<T>& operator=(const Cambio<T>&);
+
+	alignas(T) unsigned char lugar[sizeof(T)];
+	bool conSujeto;
+};
+
+/**
+ * Cola acotada de cambios entre un único hilo productor (el que modifica el
+ * contenedor) y un único hilo consumidor. Ninguno de los dos toma locks ni
+ * espera al otro: emitir es escribir en el anillo y publicar un índice, y el
+ * consumidor levanta de una vez todos los cambios que encuentra.
+ *
+ * Si el anillo está lleno el cambio se descarta y se cuenta en perdidos().
+ * El hueco queda anotado del lado del productor: el próximo emitir que
+ * encuentra lugar pone primero un CAMBIO_RESINCRONIZAR con la cantidad de
+ * cambios perdidos, así el consumidor sabe exactamente dónde está el hueco.
+ * Rearmar la copia después del hueco es cosa del productor (ver CAMBIO_FOTO).
+ */
+template<typename T>
+class CanalDeCambios {
+
+  public:
+
+	/**
+	 * Crea el canal con lugar para al menos la cantidad de cambios indicada
+	 * (se redondea a una potencia de dos).
+	 * PRE: capacidad > 0
+	 */
+	CanalDeCambios(size_t capacidad);
+
+	~CanalDeCambios();
+
+	size_t capacidad() const;
+
+	/**
+	 * Pone un cambio en la cola, precedido por la marca del hueco si antes se
+	 * perdió alguno. Devuelve false si no había lugar.
+	 * Sólo lo puede llamar el hilo productor.
+	 */
+	bool emitir(const Cambio<T>&);
+
+	/**
+	 * Cantidad de cambios que se pueden emitir seguro sin perder ninguno
+	 * (descontando la marca del hueco, si hay uno pendiente). Sólo lo puede
+	 * llamar el hilo productor.
+	 */
+	size_t lugarLibre();
+
+	/**
+	 * Pasa a procesar (en orden) hasta maximo cambios y devuelve cuántos pasó.
+	 * Recibe cada cambio como const Cambio<T>&, que vale sólo durante esa
+	 * llamada. Sólo lo puede llamar el hilo consumidor.
+	 */
+	template<typename Procesar>
+	size_t consumir(Procesar procesar, size_t maximo);
+
+	/**
+	 * Cambios en la cola. Es una foto: el otro hilo la puede cambiar enseguida.
+	 */
+	size_t pendientes() const;
+
+	/**
+	 * Cantidad de cambios descartados por falta de lugar.
+	 */
+	unsigned long perdidos() const;
+
+  private:
+
+	CanalDeCambios(const CanalDeCambios<T>&);
+	CanalDeCambios<T>& operator=(const CanalDeCambios<T>&);
+
+	Cambio<T>* en(unsigned long i) { return reinterpret_cast<Cambio<T>*>(datos) + (i & mascara); }
+
+	/**
+	 * Escribe el cambio en el anillo si hay lugar.
+	 */
+	bool poner(const Cambio<T>&);
+
+	unsigned char* datos;
+	unsigned long mascara;
+
+	// cada índice lo escribe un solo hilo; van separados para que no
+	// compartan línea de caché
+	atomic<unsigned long> escritos;
+	unsigned long leidosVistos;
+	// cambios perdidos desde la última marca que se pudo poner
+	unsigned long hueco;
+	char separador[64];
+	atomic<unsigned long> leidos;
+	unsigned long escritosVistos;
+	char separadorFinal[64];
+
+	atomic<unsigned long> descartados;
+};
+
+
+template<typename T>
+CanalDeCambios<T>::CanalDeCambios(size_t cap) : escritos(0), leidosVistos(0), hueco(0), leidos(0), escritosVistos(0), descartados(0) {
+	assert(cap > 0);
+	size_t c = 1;
+	while(c < cap){
+		c = 2 * c;
+	}
+	mascara = c - 1;
+	datos = static_cast<unsigned char*>(::operator new(c * sizeof(Cambio<T>)));
+}
+
+template<typename T>
+CanalDeCambios<T>::~CanalDeCambios(){
+	unsigned long fin = escritos.load(memory_order_acquire);
+	for(unsigned long i = leidos.load(memory_order_relaxed); i != fin; i++){
+		en(i)->~Cambio<T>();
+	}
+	::operator delete(datos);
+}
+
+template<typename T>
+size_t CanalDeCambios<T>::capacidad() const{
+	return mascara + 1;
+}
+
+template<typename T>
+bool CanalDeCambios<T>::emitir(const Cambio<T>& c){
+	if(hueco != 0){
+		if(!poner(Cambio<T>(CAMBIO_RESINCRONIZAR, hueco))){
+			hueco++;
+			descartados.fetch_add(1, memory_order_relaxed);
+			return false;
+		}
+		hueco = 0;
+	}
+	if(!poner(c)){
+		hueco++;
+		descartados.fetch_add(1, memory_order_relaxed);
+		return false;
+	}
+	return true;
+}
+
+template<typename T>
+bool CanalDeCambios<T>::poner(const Cambio<T>& c){
+	unsigned long e = escritos.load(memory_order_relaxed);
+	if(e - leidosVistos > mascara){
+		// sólo se mira el índice del consumidor cuando parece lleno
+		leidosVistos = leidos.load(memory_order_acquire);
+		if(e - leidosVistos > mascara){
+			return false;
+		}
+	}
+	new (en(e)) Cambio<T>(c);
+	escritos.store(e + 1, memory_order_release);
+	return true;
+}
+
+template<typename T>
+size_t CanalDeCambios<T>::lugarLibre(){
+	leidosVistos = leidos.load(memory_order_acquire);
+	size_t libres = mascara + 1 - (escritos.load(memory_order_relaxed) - leidosVistos);
+	if(hueco != 0 && libres > 0){
+		libres--;
+	}
+	return libres;
+}
+
+template<typename T>
+template<typename Procesar>
+size_t CanalDeCambios<T>::consumir(Procesar procesar, size_t maximo){
+	unsigned long l = leidos.load(memory_order_relaxed);
+	if(l == escritosVistos){
+		escritosVistos = escritos.load(memory_order_acquire);
+	}
+	size_t cantidad = 0;
+	while(cantidad < maximo && l + cantidad != escritosVistos){
+		Cambio<T>* c = en(l + cantidad);
+		procesar(static_cast<const Cambio<T>&>(*c));
+		c->~Cambio<T>();
+		cantidad++;
+	}
+	// el lugar se devuelve al productor de una vez para todo el lote
+	leidos.store(l + cantidad, memory_order_release);
+	return cantidad;
+}
+
+template<typename T>
+size_t CanalDeCambios<T>::pendientes() const{
+	return escritos.load(memory_order_acquire) - leidos.load(memory_order_acquire);
+}
+
+template<typename T>
+unsigned long CanalDeCambios<T>::perdidos() const{
+	return descartados.load(memory_order_relaxed);
+}
+
+#endif // CANAL_DE_CAMBIOS_H_
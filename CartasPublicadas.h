@@ -0,0 +1,331 @@
+#ifndef CARTAS_PUBLICADAS_H_
+#define CARTAS_PUBLICADAS_H_
+
+#include <atomic>
+#include <cassert>
+#include <vector>
+#include "cartas_enlazadas.h"
+using namespace std;
+
+/**
+ * Publica versiones inmutables de un juego de CartasEnlazadas para que muchos
+ * hilos las consulten mientras un único hilo escritor lo modifica (al estilo
+ * RCU). El escritor trabaja sobre un borrador propio y con publicar() deja a
+ * la vista una copia del borrador; los lectores consultan siempre una versión
+ * completa, nunca un estado a medio modificar.
+ *
+ * Los lectores no toman ningún lock ni esperan a nadie: entrar a una lectura
+ * es anotar la época actual en su lugar y leer el puntero a la versión. Las
+ * versiones reemplazadas se liberan por épocas: el escritor las guarda con la
+ * época en que las retiró y las libera cuando ningún lector anotó una época
+ * igual o anterior. El escritor tampoco espera a los lectores: lo que no puede
+ * liberar todavía lo vuelve a intentar en la próxima publicación.
+ *
+ * Publicar copia el juego entero (O(n)); conviene juntar varias jugadas antes
+ * de publicar.
+ */
+template <typename T, Nat N = 0>
+class CartasPublicadas {
+
+	struct Version;
+	struct Ranura;
+
+  public:
+
+	/**
+	 * Crea el publicador con el juego inicial ya publicado y lugar para la
+	 * cantidad de lectores indicada.
+	 * PRE: lectores > 0
+	 */
+	CartasPublicadas(const CartasEnlazadas<T, N>& inicial, unsigned int lectores);
+
+	/**
+	 * PRE: no queda ningún Lector de este publicador.
+	 */
+	~CartasPublicadas();
+
+	/**
+	 * Juego que modifica el escritor. Los cambios no se ven hasta publicar().
+	 * Sólo lo puede usar el hilo escritor.
+	 */
+	CartasEnlazadas<T, N>& borrador();
+
+	/**
+	 * Publica una copia del borrador y libera las versiones viejas que ya
+	 * ningún lector puede estar leyendo. Sólo lo puede llamar el hilo escritor.
+	 */
+	void publicar();
+
+	/**
+	 * Número de la última versión publicada (la inicial es la 1).
+	 */
+	unsigned long versionPublicada() const;
+
+	/**
+	 * Cantidad de versiones reemplazadas que todavía no se pudieron liberar.
+	 * Sólo lo puede llamar el hilo escritor.
+	 */
+	unsigned int versionesRetenidas() const;
+
+	/**
+	 * Lugar de lectura de un hilo. Cada hilo lector crea el suyo y lo usa
+	 * para todas sus lecturas; crearlo y destruirlo no es wait-free, leer sí.
+	 */
+	class Lector {
+	  public:
+
+		/**
+		 * PRE: hay un lugar libre en el publicador.
+		 */
+		Lector(CartasPublicadas<T, N>& publicador);
+		~Lector();
+
+	  private:
+		friend class CartasPublicadas<T, N>;
+		Lector(const Lector&);
+		Lector& operator=(const Lector&);
+
+		CartasPublicadas<T, N>& publicador;
+		Ranura* ranura;
+		bool leyendo;
+	};
+
+	/**
+	 * Lectura de una versión: mientras exista, la versión no se libera y todas
+	 * las consultas ven el mismo juego. Los T que devuelve valen mientras dure
+	 * la lectura.
+	 * PRE: el lector no tiene otra lectura abierta.
+	 */
+	class Lectura {
+	  public:
+
+		Lectura(Lector& lector);
+		~Lectura();
+
+		unsigned long version() const;
+
+		int tamanio() const;
+		bool existeJugador(const T&) const;
+
+		/**
+		 * PRE: el juego no está vacío.
+		 */
+		const T& dameJugadorConMazoRojo() const;
+		const T& dameJugadorConMazoAzul() const;
+		const T& dameJugadorEnfrentado() const;
+
+		/**
+		 * PRE: el jugador existe.
+		 */
+		int puntosDelJugador(const T&) const;
+
+		/**
+		 * PRE: el juego no está vacío y hay un único jugador con más puntos.
+		 */
+		const T& ganador() const;
+
+	  private:
+		Lectura(const Lectura&);
+		Lectura& operator=(const Lectura&);
+
+		Lector& lector;
+		const Version* actual;
+	};
+
+  private:
+
+	CartasPublicadas(const CartasPublicadas<T, N>&);
+	CartasPublicadas<T, N>& operator=(const CartasPublicadas<T, N>&);
+
+	/**
+	 * Copia publicada del juego. Se deja lista para leer antes de publicarla
+	 * (mazos resueltos e índice de puntajes armado), así que las consultas de
+	 * Lectura sólo leen y varios hilos pueden hacerlas a la vez.
+	 */
+	struct Version {
+		CartasEnlazadas<T, N> juego;
+		unsigned long numero;
+		Version(const CartasEnlazadas<T, N>& j, unsigned long n);
+	};
+
+	/**
+	 * Lugar de un lector. epoca es 0 mientras no está leyendo.
+	 */
+	struct Ranura {
+		atomic<bool> ocupada;
+		atomic<unsigned long> epoca;
+		Ranura() : ocupada(false), epoca(0) {}
+	};
+
+	struct Retirada {
+		Version* version;
+		unsigned long epoca;
+	};
+
+	/**
+	 * Libera las versiones retiradas antes de la época más vieja que tiene
+	 * anotada algún lector.
+	 */
+	void recolectar();
+
+	CartasEnlazadas<T, N> enEdicion;
+	atomic<Version*> publicada;
+	// arranca en 1 para que 0 marque a los lectores que no están leyendo
+	atomic<unsigned long> epoca;
+	Ranura* ranuras;
+	unsigned int cantidadDeRanuras;
+	vector<Retirada> retiradas;
+};
+
+
+template <typename T, Nat N>
+CartasPublicadas<T, N>::Version::Version(const CartasEnlazadas<T, N>& j, unsigned long n) : juego(j), numero(n) {
+	if(!juego.esVacia()){
+		// resuelve los mazos pendientes y arma el índice
+		juego.dameJugadorConMazoAzul();
+		juego.ganador();
+	}
+}
+
+template <typename T, Nat N>
+CartasPublicadas<T, N>::CartasPublicadas(const CartasEnlazadas<T, N>& inicial, unsigned int lectores)
+	: enEdicion(inicial), publicada(NULL), epoca(1), cantidadDeRanuras(lectores) {
+	assert(lectores > 0);
+	ranuras = new Ranura[lectores];
+	publicada.store(new Version(enEdicion, 1));
+}
+
+template <typename T, Nat N>
+CartasPublicadas<T, N>::~CartasPublicadas(){
+	for(unsigned int i = 0; i < cantidadDeRanuras; i++){
+		assert(!ranuras[i].ocupada.load());
+	}
+	for(unsigned int i = 0; i < retiradas.size(); i++){
+		delete retiradas[i].version;
+	}
+	delete publicada.load();
+	delete[] ranuras;
+}
+
+template <typename T, Nat N>
+CartasEnlazadas<T, N>& CartasPublicadas<T, N>::borrador(){
+	return enEdicion;
+}
+
+template <typename T, Nat N>
+void CartasPublicadas<T, N>::publicar(){
+	Version* nueva = new Version(enEdicion, publicada.load()->numero + 1);
+	Version* vieja = publicada.exchange(nueva);
+	// los lectores que anoten una época posterior ya no pueden ver a vieja
+	Retirada r;
+	r.version = vieja;
+	r.epoca = epoca.fetch_add(1);
+	retiradas.push_back(r);
+	recolectar();
+}
+
+template <typename T, Nat N>
+void CartasPublicadas<T, N>::recolectar(){
+	unsigned long masVieja = epoca.load();
+	for(unsigned int i = 0; i < cantidadDeRanuras; i++){
+		unsigned long e = ranuras[i].epoca.load();
+		if(e != 0 && e < masVieja){
+			masVieja = e;
+		}
+	}
+	unsigned int quedan = 0;
+	for(unsigned int i = 0; i < retiradas.size(); i++){
+		if(retiradas[i].epoca < masVieja){
+			delete retiradas[i].version;
+		}else{
+			retiradas[quedan] = retiradas[i];
+			quedan++;
+		}
+	}
+	retiradas.resize(quedan);
+}
+
+template <typename T, Nat N>
+unsigned long CartasPublicadas<T, N>::versionPublicada() const{
+	return publicada.load()->numero;
+}
+
+template <typename T, Nat N>
+unsigned int CartasPublicadas<T, N>::versionesRetenidas() const{
+	return retiradas.size();
+}
+
+template <typename T, Nat N>
+CartasPublicadas<T, N>::Lector::Lector(CartasPublicadas<T, N>& p) : publicador(p), ranura(NULL), leyendo(false) {
+	for(unsigned int i = 0; i < publicador.cantidadDeRanuras && ranura == NULL; i++){
+		bool libre = false;
+		if(publicador.ranuras[i].ocupada.compare_exchange_strong(libre, true)){
+			ranura = &publicador.ranuras[i];
+		}
+	}
+	assert(ranura != NULL);
+}
+
+template <typename T, Nat N>
+CartasPublicadas<T, N>::Lector::~Lector(){
+	assert(!leyendo);
+	ranura->ocupada.store(false);
+}
+
+template <typename T, Nat N>
+CartasPublicadas<T, N>::Lectura::Lectura(Lector& l) : lector(l) {
+	assert(!lector.leyendo);
+	lector.leyendo = true;
+	// anotar la época antes de leer el puntero: el escritor no libera nada
+	// que se haya retirado desde entonces
+	lector.ranura->epoca.store(lector.publicador.epoca.load());
+	actual = lector.publicador.publicada.load();
+}
+
+template <typename T, Nat N>
+CartasPublicadas<T, N>::Lectura::~Lectura(){
+	lector.ranura->epoca.store(0);
+	lector.leyendo = false;
+}
+
+template <typename T, Nat N>
+unsigned long CartasPublicadas<T, N>::Lectura::version() const{
+	return actual->numero;
+}
+
+template <typename T, Nat N>
+int CartasPublicadas<T, N>::Lectura::tamanio() const{
+	return actual->juego.tamanio();
+}
+
+template <typename T, Nat N>
+bool CartasPublicadas<T, N>::Lectura::existeJugador(const T& j) const{
+	return actual->juego.existeJugador(j);
+}
+
+template <typename T, Nat N>
+const T& CartasPublicadas<T, N>::Lectura::dameJugadorConMazoRojo() const{
+	return actual->juego.dameJugadorConMazoRojo();
+}
+
+template <typename T, Nat N>
+const T& CartasPublicadas<T, N>::Lectura::dameJugadorConMazoAzul() const{
+	return actual->juego.dameJugadorConMazoAzul();
+}
+
+template <typename T, Nat N>
+const T& CartasPublicadas<T, N>::Lectura::dameJugadorEnfrentado() const{
+	return actual->juego.dameJugadorEnfrentado();
+}
+
+template <typename T, Nat N>
+int CartasPublicadas<T, N>::Lectura::puntosDelJugador(const T& j) const{
+	return actual->juego.puntosDelJugador(j);
+}
+
+template <typename T, Nat N>
+const T& CartasPublicadas<T, N>::Lectura::ganador() const{
+	return actual->juego.ganador();
+}
+
+#endif // CARTAS_PUBLICADAS_H_
@@ -0,0 +1,297 @@
+#ifndef EJECUTOR_CORRUTINAS_H_
+#define EJECUTOR_CORRUTINAS_H_
+
+#if !defined(__cpp_impl_coroutine)
+#error "EjecutorCorrutinas.h necesita corrutinas de C++20 (g++ -std=c++20)"
+#endif
+
+#include <cassert>
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+#include "PlanificadorRR.h"
+using namespace std;
+
+class EjecutorRR;
+class Evento;
+
+/**
+ * Tipo de retorno de las corrutinas que corre un EjecutorRR. La corrutina
+ * arranca suspendida y recién empieza a correr cuando el ejecutor la elige.
+ */
+class Tarea {
+
+  public:
+
+	/**
+	 * Qué pidió la tarea en su último co_await.
+	 */
+	enum Accion { CEDER, DORMIR, ESPERAR };
+
+	struct promise_type {
+		Accion accion;
+		unsigned long ticks;
+		Evento* evento;
+
+		promise_type() : accion(CEDER), ticks(0), evento(NULL) {}
+		Tarea get_return_object() { return Tarea(std::coroutine_handle<promise_type>::from_promise(*this)); }
+		std::suspend_always initial_suspend() noexcept { return std::suspend_always(); }
+		std::suspend_always final_suspend() noexcept { return std::suspend_always(); }
+		void return_void() {}
+		void unhandled_exception() { std::terminate(); }
+	};
+
+	Tarea(Tarea&& otra) : corrutina(otra.corrutina) { otra.corrutina = std::coroutine_handle<promise_type>(); }
+
+	~Tarea() {
+		if(corrutina){
+			corrutina.destroy();
+		}
+	}
+
+  private:
+	friend class EjecutorRR;
+
+	Tarea(std::coroutine_handle<promise_type> c) : corrutina(c) {}
+	Tarea(const Tarea&);
+	Tarea& operator=(const Tarea&);
+
+	std::coroutine_handle<promise_type> corrutina;
+};
+
+/**
+ * Ejecutor cooperativo de un solo hilo. Cada tarea es un proceso (su número)
+ * en un PlanificadorRR: ejecutarSiguiente() reanuda a la tarea en ejecución
+ * hasta su siguiente co_await y después aplica lo que pidió:
+ *  - co_await ceder(): pasa a ejecutarse la siguiente tarea activa.
+ *  - co_await dormir(n): la tarea se pausa y se reanuda n ticks después.
+ *  - co_await esperar(e): la tarea se pausa hasta que se señale el evento e.
+ * Cada llamada a ejecutarSiguiente() es un tick del reloj.
+ */
+class EjecutorRR {
+
+  public:
+
+	EjecutorRR() : reloj(0) {}
+
+	/**
+	 * Destruye las tareas que no terminaron.
+	 */
+	~EjecutorRR() {
+		for(unsigned int i = 0; i < tareas.size(); i++){
+			if(tareas[i]){
+				tareas[i].destroy();
+			}
+		}
+	}
+
+	/**
+	 * Pasa a planificar la tarea, que queda antes de la que está en ejecución.
+	 * Devuelve el número de proceso con el que se la planifica.
+	 */
+	unsigned int lanzar(Tarea t);
+
+	/**
+	 * Corre la tarea en ejecución hasta su siguiente co_await (o hasta que
+	 * termine). Si no hay tareas activas pero hay tareas dormidas, adelanta el
+	 * reloj hasta que se despierte la primera.
+	 * Devuelve false si no se corrió nada: el ejecutor está detenido, no quedan
+	 * tareas o todas esperan un evento.
+	 */
+	bool ejecutarSiguiente();
+
+	/**
+	 * Llama a ejecutarSiguiente() hasta que devuelva false. Devuelve la
+	 * cantidad de pasos ejecutados.
+	 */
+	unsigned long correr();
+
+	/**
+	 * Detiene y reanuda el planificador subyacente.
+	 */
+	void detener() { plan.detener(); }
+	void reanudar() { plan.reanudar(); }
+
+	/**
+	 * Devuelve la cantidad de ticks transcurridos.
+	 */
+	unsigned long tiempo() const { return reloj; }
+
+	/**
+	 * Devuelve la cantidad de tareas sin terminar.
+	 */
+	int cantidadDeTareas() const { return plan.cantidadDeProcesos(); }
+
+	/**
+	 * Planificador con los números de las tareas, para consultarlo o mostrarlo.
+	 */
+	const PlanificadorRR<unsigned int>& planificador() const { return plan; }
+
+  private:
+	friend class Evento;
+
+	EjecutorRR(const EjecutorRR&);
+	EjecutorRR& operator=(const EjecutorRR&);
+
+	typedef std::coroutine_handle<Tarea::promise_type> Corrutina;
+	typedef std::pair<unsigned long, unsigned int> Despertador;
+
+	/**
+	 * Reanuda las tareas dormidas cuyo tick ya llegó.
+	 */
+	void despertarVencidas();
+
+	PlanificadorRR<unsigned int> plan;
+	vector<Corrutina> tareas;
+	// manija de cada tarea en el planificador, para pausarla y reanudarla en O(1)
+	vector<Manija> manijas;
+	vector<unsigned int> libres;
+	priority_queue<Despertador, vector<Despertador>, greater<Despertador> > dormidas;
+	unsigned long reloj;
+};
+
+/**
+ * Evento al que pueden esperar las tareas de un ejecutor. senalar() reanuda
+ * a todas las tareas que lo estaban esperando (no queda señalado para las
+ * que lo esperen después).
+ */
+class Evento {
+
+  public:
+
+	Evento(EjecutorRR& e) : ejecutor(&e) {}
+
+	void senalar() {
+		for(unsigned int i = 0; i < esperando.size(); i++){
+			ejecutor->plan.reanudarProceso(ejecutor->manijas[esperando[i]]);
+		}
+		esperando.clear();
+	}
+
+	/**
+	 * Devuelve la cantidad de tareas que esperan el evento.
+	 */
+	unsigned int cantidadEsperando() const { return esperando.size(); }
+
+  private:
+	friend class EjecutorRR;
+
+	EjecutorRR* ejecutor;
+	vector<unsigned int> esperando;
+};
+
+/**
+ * Lo que se puede esperar con co_await dentro de una Tarea.
+ */
+struct Ceder {
+	bool await_ready() const noexcept { return false; }
+	void await_suspend(std::coroutine_handle<Tarea::promise_type> c) const noexcept {
+		c.promise().accion = Tarea::CEDER;
+	}
+	void await_resume() const noexcept {}
+};
+
+struct Dormir {
+	unsigned long ticks;
+	bool await_ready() const noexcept { return false; }
+	void await_suspend(std::coroutine_handle<Tarea::promise_type> c) const noexcept {
+		c.promise().accion = Tarea::DORMIR;
+		c.promise().ticks = ticks;
+	}
+	void await_resume() const noexcept {}
+};
+
+struct Esperar {
+	Evento* evento;
+	bool await_ready() const noexcept { return false; }
+	void await_suspend(std::coroutine_handle<Tarea::promise_type> c) const noexcept {
+		c.promise().accion = Tarea::ESPERAR;
+		c.promise().evento = evento;
+	}
+	void await_resume() const noexcept {}
+};
+
+inline Ceder ceder() { return Ceder(); }
+inline Dormir dormir(unsigned long ticks) { Dormir d; d.ticks = ticks; return d; }
+inline Esperar esperar(Evento& e) { Esperar w; w.evento = &e; return w; }
+
+
+inline unsigned int EjecutorRR::lanzar(Tarea t){
+	unsigned int id;
+	if(libres.empty()){
+		id = tareas.size();
+		tareas.push_back(t.corrutina);
+		manijas.push_back(plan.agregarProceso(id));
+	}else{
+		id = libres.back();
+		libres.pop_back();
+		tareas[id] = t.corrutina;
+		manijas[id] = plan.agregarProceso(id);
+	}
+	t.corrutina = Corrutina();
+	return id;
+}
+
+inline void EjecutorRR::despertarVencidas(){
+	while(!dormidas.empty() && dormidas.top().first <= reloj){
+		plan.reanudarProceso(manijas[dormidas.top().second]);
+		dormidas.pop();
+	}
+}
+
+inline bool EjecutorRR::ejecutarSiguiente(){
+	if(plan.detenido()){
+		return false;
+	}
+	despertarVencidas();
+	if(!plan.hayProcesosActivos()){
+		if(dormidas.empty()){
+			return false;
+		}
+		reloj = dormidas.top().first;
+		despertarVencidas();
+	}
+	unsigned int id = plan.procesoEjecutado();
+	Corrutina c = tareas[id];
+	c.resume();
+	reloj++;
+	if(c.done()){
+		plan.eliminarProceso(manijas[id]);
+		c.destroy();
+		tareas[id] = Corrutina();
+		libres.push_back(id);
+		return true;
+	}
+	Tarea::promise_type& p = c.promise();
+	switch(p.accion){
+		case Tarea::CEDER:
+			plan.ejecutarSiguienteProceso();
+			break;
+		case Tarea::DORMIR:
+			if(p.ticks == 0){
+				plan.ejecutarSiguienteProceso();
+			}else{
+				plan.pausarProceso(manijas[id]);
+				dormidas.push(Despertador(reloj + p.ticks, id));
+			}
+			break;
+		case Tarea::ESPERAR:
+			plan.pausarProceso(manijas[id]);
+			p.evento->esperando.push_back(id);
+			break;
+	}
+	return true;
+}
+
+inline unsigned long EjecutorRR::correr(){
+	unsigned long pasos = 0;
+	while(ejecutarSiguiente()){
+		pasos++;
+	}
+	return pasos;
+}
+
+#endif // EJECUTOR_CORRUTINAS_H_
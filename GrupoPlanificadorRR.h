@@ -0,0 +1,490 @@
+#ifndef GRUPO_PLANIFICADOR_RR_H_
+#define GRUPO_PLANIFICADOR_RR_H_
+
+#include <iostream>
+#include <cassert>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include "PlanificadorRR.h"
+using namespace std;
+
+/**
+ * Agrupa un PlanificadorRR por núcleo (uno por hilo trabajador).
+ * Cada núcleo tiene su propio mutex, así que los hilos que despachan en
+ * núcleos distintos no se bloquean entre sí. Un núcleo sin procesos activos
+ * le roba procesos activos a sus pares, y balancear() reparte los procesos
+ * activos para emparejar las cantidades.
+ *
+ * Las operaciones sobre un proceso por nombre (agregar, eliminar, pausar,
+ * reanudar y las consultas sobre él) bloquean todos los núcleos, siempre en
+ * el mismo orden, para que robar o balancear no lo muevan a un núcleo que la
+ * búsqueda ya pasó. Las cantidades globales recorren los núcleos de a uno,
+ * por lo que reflejan un estado consistente sólo si no hay otros hilos
+ * modificando el grupo.
+ *
+ * Se puede asumir que el tipo T tiene constructor por copia y operator==
+ * No se puede asumir que el tipo T tenga operator=
+ */
+template<typename T>
+class GrupoPlanificadorRR {
+
+  public:
+
+	/**
+	 * Crea un grupo con la cantidad de núcleos indicada, todos vacíos.
+	 * PRE: nucleos > 0
+	 */
+	GrupoPlanificadorRR(unsigned int nucleos);
+
+	~GrupoPlanificadorRR();
+
+	/**
+	 * Devuelve la cantidad de núcleos del grupo.
+	 */
+	unsigned int cantidadDeNucleos() const;
+
+	/**
+	 * Agrega un proceso al núcleo con menos procesos.
+	 * PRE: El proceso no está siendo planificado en ningún núcleo.
+	 */
+	void agregarProceso(const T&);
+
+	/**
+	 * Agrega un proceso a un núcleo en particular.
+	 * PRE: El proceso no está siendo planificado en ningún núcleo.
+	 * PRE: nucleo < cantidadDeNucleos()
+	 */
+	void agregarProceso(unsigned int nucleo, const T&);
+
+	/**
+	 * Elimina un proceso del núcleo en el que esté planificado.
+	 * PRE: El proceso está siendo planificado en algún núcleo.
+	 */
+	void eliminarProceso(const T&);
+
+	/**
+	 * Pausa un proceso del núcleo en el que esté planificado.
+	 * PRE: El proceso está siendo planificado en algún núcleo y está activo.
+	 */
+	void pausarProceso(const T&);
+
+	/**
+	 * Reanuda un proceso del núcleo en el que esté planificado.
+	 * PRE: El proceso está siendo planificado en algún núcleo y está inactivo.
+	 */
+	void reanudarProceso(const T&);
+
+	/**
+	 * Ejecuta el siguiente proceso activo del núcleo. Si el núcleo no tiene
+	 * procesos activos, antes intenta robarle procesos a otro núcleo.
+	 * Devuelve false si el grupo está detenido o no hay nada para ejecutar.
+	 * PRE: nucleo < cantidadDeNucleos()
+	 */
+	bool ejecutarSiguienteProceso(unsigned int nucleo);
+
+	/**
+	 * Devuelve una copia del proceso en ejecución en el núcleo (una copia,
+	 * porque otro hilo puede migrarlo en cualquier momento).
+	 * PRE: El núcleo tiene al menos un proceso activo.
+	 */
+	T procesoEjecutado(unsigned int nucleo) const;
+
+	/**
+	 * Le roba al núcleo con más procesos activos la mitad de los que no están
+	 * en ejecución y los agrega al núcleo indicado. Devuelve cuántos robó.
+	 * PRE: nucleo < cantidadDeNucleos()
+	 */
+	unsigned int robar(unsigned int nucleo);
+
+	/**
+	 * Migra procesos activos desde los núcleos más cargados a los menos
+	 * cargados hasta que las cantidades de procesos activos difieran a lo
+	 * sumo en uno. Pensado para llamarse periódicamente.
+	 * Devuelve la cantidad de procesos migrados.
+	 */
+	unsigned int balancear();
+
+	/**
+	 * Detiene todos los núcleos.
+	 * PRE: El grupo no está detenido.
+	 */
+	void detener();
+
+	/**
+	 * Reanuda todos los núcleos.
+	 * PRE: El grupo está detenido.
+	 */
+	void reanudar();
+
+	/**
+	 * Informa si el grupo está detenido.
+	 */
+	bool detenido() const;
+
+	/**
+	 * Informa si el proceso está planificado en algún núcleo.
+	 */
+	bool esPlanificado(const T&) const;
+
+	/**
+	 * Informa si el proceso está activo.
+	 * PRE: El proceso está siendo planificado en algún núcleo.
+	 */
+	bool estaActivo(const T&) const;
+
+	/**
+	 * Devuelve el núcleo en el que está planificado el proceso, o -1.
+	 */
+	int nucleoDe(const T&) const;
+
+	/**
+	 * Informa si existen procesos activos en algún núcleo.
+	 */
+	bool hayProcesosActivos() const;
+
+	/**
+	 * Devuelve la cantidad de procesos planificados en todos los núcleos.
+	 */
+	int cantidadDeProcesos() const;
+
+	/**
+	 * Devuelve la cantidad de procesos activos en todos los núcleos.
+	 */
+	int cantidadDeProcesosActivos() const;
+
+	/**
+	 * Devuelve la cantidad de procesos activos del núcleo.
+	 */
+	int cantidadDeProcesosActivos(unsigned int nucleo) const;
+
+	/**
+	 * Muestra cada núcleo con el formato de mostrarPlanificadorRR:
+	 * {[p0*, p1], [], [p2*]}
+	 */
+	ostream& mostrarGrupoPlanificadorRR(ostream&) const;
+
+  private:
+
+	GrupoPlanificadorRR(const GrupoPlanificadorRR<T>&);
+	GrupoPlanificadorRR<T>& operator=(const GrupoPlanificadorRR<T>&);
+
+	struct Nucleo {
+		mutable std::mutex mutex;
+		PlanificadorRR<T> plan;
+	};
+
+	typedef vector< std::unique_lock<std::mutex> > Bloqueos;
+
+	/**
+	 * Bloquea todos los núcleos en orden de índice.
+	 */
+	void bloquearTodos(Bloqueos&) const;
+
+	/**
+	 * Devuelve el núcleo en el que está planificado el proceso, o -1.
+	 * Todos los núcleos deben estar bloqueados.
+	 */
+	int buscarNucleo(const T&) const;
+
+	/**
+	 * Pasa hasta maximo procesos activos que no estén en ejecución de origen
+	 * a destino, cada uno con su estado y en O(1) por proceso. Ambos núcleos
+	 * deben estar bloqueados. Devuelve cuántos pasó.
+	 */
+	unsigned int migrar(Nucleo& origen, Nucleo& destino, unsigned int maximo);
+
+	Nucleo* nucleos;
+	unsigned int cantidad;
+	std::atomic<bool> estado;
+};
+
+
+template<typename T>
+GrupoPlanificadorRR<T>::GrupoPlanificadorRR(unsigned int n): nucleos(NULL), cantidad(n), estado(true){
+	assert(n > 0);
+	nucleos = new Nucleo[n];
+}
+
+template<typename T>
+GrupoPlanificadorRR<T>::~GrupoPlanificadorRR(){
+	delete[] nucleos;
+}
+
+template<typename T>
+unsigned int GrupoPlanificadorRR<T>::cantidadDeNucleos() const{
+	return cantidad;
+}
+
+template<typename T>
+void GrupoPlanificadorRR<T>::agregarProceso(const T& proc){
+	Bloqueos bloqueos;
+	bloquearTodos(bloqueos);
+	assert(buscarNucleo(proc) == -1);
+	unsigned int elegido = 0;
+	for(unsigned int i = 1; i < cantidad; i++){
+		if(nucleos[i].plan.cantidadDeProcesos() < nucleos[elegido].plan.cantidadDeProcesos()){
+			elegido = i;
+		}
+	}
+	nucleos[elegido].plan.agregarProceso(proc);
+}
+
+template<typename T>
+void GrupoPlanificadorRR<T>::agregarProceso(unsigned int nucleo, const T& proc){
+	assert(nucleo < cantidad);
+	Bloqueos bloqueos;
+	bloquearTodos(bloqueos);
+	assert(buscarNucleo(proc) == -1);
+	nucleos[nucleo].plan.agregarProceso(proc);
+}
+
+template<typename T>
+void GrupoPlanificadorRR<T>::eliminarProceso(const T& proc){
+	Bloqueos bloqueos;
+	bloquearTodos(bloqueos);
+	int i = buscarNucleo(proc);
+	assert(i != -1);
+	nucleos[i].plan.eliminarProceso(proc);
+}
+
+template<typename T>
+void GrupoPlanificadorRR<T>::pausarProceso(const T& proc){
+	Bloqueos bloqueos;
+	bloquearTodos(bloqueos);
+	int i = buscarNucleo(proc);
+	assert(i != -1);
+	nucleos[i].plan.pausarProceso(proc);
+}
+
+template<typename T>
+void GrupoPlanificadorRR<T>::reanudarProceso(const T& proc){
+	Bloqueos bloqueos;
+	bloquearTodos(bloqueos);
+	int i = buscarNucleo(proc);
+	assert(i != -1);
+	nucleos[i].plan.reanudarProceso(proc);
+}
+
+template<typename T>
+bool GrupoPlanificadorRR<T>::ejecutarSiguienteProceso(unsigned int nucleo){
+	assert(nucleo < cantidad);
+	if(!estado){
+		return false;
+	}
+	{
+		std::lock_guard<std::mutex> l(nucleos[nucleo].mutex);
+		if(nucleos[nucleo].plan.hayProcesosActivos()){
+			nucleos[nucleo].plan.ejecutarSiguienteProceso();
+			return true;
+		}
+	}
+	// el núcleo quedó sin trabajo: como no tenía procesos activos, al agregar
+	// los robados uno de ellos queda en ejecución
+	return robar(nucleo) > 0;
+}
+
+template<typename T>
+T GrupoPlanificadorRR<T>::procesoEjecutado(unsigned int nucleo) const{
+	assert(nucleo < cantidad);
+	std::lock_guard<std::mutex> l(nucleos[nucleo].mutex);
+	return nucleos[nucleo].plan.procesoEjecutado();
+}
+
+template<typename T>
+unsigned int GrupoPlanificadorRR<T>::robar(unsigned int nucleo){
+	assert(nucleo < cantidad);
+	// se elige la víctima sin bloquear a todos; si cambió mientras tanto,
+	// migrar() simplemente roba menos
+	unsigned int victima = nucleo;
+	int mayor = 1;
+	for(unsigned int i = 1; i < cantidad; i++){
+		unsigned int j = (nucleo + i) % cantidad;
+		int c = cantidadDeProcesosActivos(j);
+		if(c > mayor){
+			mayor = c;
+			victima = j;
+		}
+	}
+	if(victima == nucleo){
+		return 0;
+	}
+	std::unique_lock<std::mutex> a(nucleos[nucleo].mutex, std::defer_lock);
+	std::unique_lock<std::mutex> b(nucleos[victima].mutex, std::defer_lock);
+	std::lock(a, b);
+	unsigned int mitad = nucleos[victima].plan.cantidadDeProcesosActivos() / 2;
+	return migrar(nucleos[victima], nucleos[nucleo], mitad);
+}
+
+template<typename T>
+unsigned int GrupoPlanificadorRR<T>::balancear(){
+	Bloqueos bloqueos;
+	bloquearTodos(bloqueos);
+	vector<int> activos(cantidad);
+	for(unsigned int i = 0; i < cantidad; i++){
+		activos[i] = nucleos[i].plan.cantidadDeProcesosActivos();
+	}
+	unsigned int migrados = 0;
+	while(true){
+		unsigned int max = 0;
+		unsigned int min = 0;
+		for(unsigned int i = 1; i < cantidad; i++){
+			if(activos[i] > activos[max]){
+				max = i;
+			}
+			if(activos[i] < activos[min]){
+				min = i;
+			}
+		}
+		if(activos[max] - activos[min] <= 1){
+			break;
+		}
+		unsigned int m = migrar(nucleos[max], nucleos[min], (activos[max] - activos[min]) / 2);
+		if(m == 0){
+			break;
+		}
+		activos[max] -= m;
+		activos[min] += m;
+		migrados += m;
+	}
+	return migrados;
+}
+
+template<typename T>
+unsigned int GrupoPlanificadorRR<T>::migrar(Nucleo& origen, Nucleo& destino, unsigned int maximo){
+	// se juntan primero las manijas: mover uno no invalida las de los demás
+	vector<Manija> elegidos;
+	typename PlanificadorRR<T>::Vista activos = origen.plan.vistaActivos();
+	typename PlanificadorRR<T>::const_iterator it = activos.end();
+	while(elegidos.size() < maximo && it != activos.begin()){
+		--it;
+		if(!it.ejecutado()){
+			elegidos.push_back(it.manija());
+		}
+	}
+	for(unsigned int i = 0; i < elegidos.size(); i++){
+		destino.plan.transferirProcesos(origen.plan, elegidos[i], 1);
+	}
+	return elegidos.size();
+}
+
+template<typename T>
+void GrupoPlanificadorRR<T>::bloquearTodos(Bloqueos& bloqueos) const{
+	for(unsigned int i = 0; i < cantidad; i++){
+		bloqueos.push_back(std::unique_lock<std::mutex>(nucleos[i].mutex));
+	}
+}
+
+template<typename T>
+int GrupoPlanificadorRR<T>::buscarNucleo(const T& proc) const{
+	for(unsigned int i = 0; i < cantidad; i++){
+		if(nucleos[i].plan.esPlanificado(proc)){
+			return i;
+		}
+	}
+	return -1;
+}
+
+template<typename T>
+void GrupoPlanificadorRR<T>::detener(){
+	assert(estado);
+	for(unsigned int i = 0; i < cantidad; i++){
+		std::lock_guard<std::mutex> l(nucleos[i].mutex);
+		nucleos[i].plan.detener();
+	}
+	estado = false;
+}
+
+template<typename T>
+void GrupoPlanificadorRR<T>::reanudar(){
+	assert(!estado);
+	for(unsigned int i = 0; i < cantidad; i++){
+		std::lock_guard<std::mutex> l(nucleos[i].mutex);
+		nucleos[i].plan.reanudar();
+	}
+	estado = true;
+}
+
+template<typename T>
+bool GrupoPlanificadorRR<T>::detenido() const{
+	return !estado;
+}
+
+template<typename T>
+bool GrupoPlanificadorRR<T>::esPlanificado(const T& proc) const{
+	return nucleoDe(proc) != -1;
+}
+
+template<typename T>
+bool GrupoPlanificadorRR<T>::estaActivo(const T& proc) const{
+	Bloqueos bloqueos;
+	bloquearTodos(bloqueos);
+	int i = buscarNucleo(proc);
+	assert(i != -1);
+	return nucleos[i].plan.estaActivo(proc);
+}
+
+template<typename T>
+int GrupoPlanificadorRR<T>::nucleoDe(const T& proc) const{
+	Bloqueos bloqueos;
+	bloquearTodos(bloqueos);
+	return buscarNucleo(proc);
+}
+
+template<typename T>
+bool GrupoPlanificadorRR<T>::hayProcesosActivos() const{
+	for(unsigned int i = 0; i < cantidad; i++){
+		std::lock_guard<std::mutex> l(nucleos[i].mutex);
+		if(nucleos[i].plan.hayProcesosActivos()){
+			return true;
+		}
+	}
+	return false;
+}
+
+template<typename T>
+int GrupoPlanificadorRR<T>::cantidadDeProcesos() const{
+	int res = 0;
+	for(unsigned int i = 0; i < cantidad; i++){
+		std::lock_guard<std::mutex> l(nucleos[i].mutex);
+		res += nucleos[i].plan.cantidadDeProcesos();
+	}
+	return res;
+}
+
+template<typename T>
+int GrupoPlanificadorRR<T>::cantidadDeProcesosActivos() const{
+	int res = 0;
+	for(unsigned int i = 0; i < cantidad; i++){
+		res += cantidadDeProcesosActivos(i);
+	}
+	return res;
+}
+
+template<typename T>
+int GrupoPlanificadorRR<T>::cantidadDeProcesosActivos(unsigned int nucleo) const{
+	assert(nucleo < cantidad);
+	std::lock_guard<std::mutex> l(nucleos[nucleo].mutex);
+	return nucleos[nucleo].plan.cantidadDeProcesosActivos();
+}
+
+template<typename T>
+ostream& GrupoPlanificadorRR<T>::mostrarGrupoPlanificadorRR(ostream& os) const{
+	os << "{";
+	for(unsigned int i = 0; i < cantidad; i++){
+		std::lock_guard<std::mutex> l(nucleos[i].mutex);
+		if(i > 0){
+			os << ", ";
+		}
+		nucleos[i].plan.mostrarPlanificadorRR(os);
+	}
+	os << "}";
+	return os;
+}
+
+template<class T>
+ostream& operator<<(ostream& out, const GrupoPlanificadorRR<T>& a) {
+	return a.mostrarGrupoPlanificadorRR(out);
+}
+
+#endif // GRUPO_PLANIFICADOR_RR_H_
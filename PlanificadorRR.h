@@ -1,10 +1,227 @@
 #ifndef PLANIFICADOR_RR_H_
 #define PLANIFICADOR_RR_H_
 
+#include <algorithm>
 #include <iostream>
 #include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <vector>
+#include "CanalDeCambios.h"
+#include "azar.h"
+#include "claves.h"
+#include "manijas.h"
+#include "memoria.h"
 using namespace std;
 
+/**
+ * Montículo binario de mínimos sobre identificadores (enteros chicos, como
+ * las ranuras de las manijas) con una clave cada uno. Guarda la posición de
+ * cada identificador, así que quitar cualquiera o cambiarle la clave cuesta
+ * O(log n). A igual clave sale primero el identificador menor.
+ */
+class MonticuloIndexado {
+
+  public:
+
+	bool vacio() const { return monticulo.empty(); }
+
+	unsigned int cantidad() const { return monticulo.size(); }
+
+	bool contiene(unsigned int id) const { return id < posicion.size() && posicion[id] >= 0; }
+
+	/**
+	 * PRE: no está vacío.
+	 */
+	unsigned int minimo() const { return monticulo[0]; }
+	unsigned long claveMinima() const { return claves[monticulo[0]]; }
+
+	unsigned long clave(unsigned int id) const { return claves[id]; }
+
+	/**
+	 * PRE: id no está en el montículo.
+	 */
+	void insertar(unsigned int id, unsigned long c) {
+		if(id >= posicion.size()){
+			posicion.resize(id + 1, -1);
+			claves.resize(id + 1, 0);
+		}
+		claves[id] = c;
+		posicion[id] = monticulo.size();
+		monticulo.push_back(id);
+		subir(posicion[id]);
+	}
+
+	/**
+	 * PRE: id está en el montículo.
+	 */
+	void quitar(unsigned int id) {
+		unsigned int i = posicion[id];
+		unsigned int ultimo = monticulo.back();
+		monticulo.pop_back();
+		posicion[id] = -1;
+		if(ultimo != id){
+			monticulo[i] = ultimo;
+			posicion[ultimo] = i;
+			subir(i);
+			bajar(posicion[ultimo]);
+		}
+	}
+
+	/**
+	 * PRE: id está en el montículo.
+	 */
+	void cambiar(unsigned int id, unsigned long c) {
+		claves[id] = c;
+		subir(posicion[id]);
+		bajar(posicion[id]);
+	}
+
+	void vaciar() {
+		monticulo.clear();
+		posicion.clear();
+		claves.clear();
+	}
+
+	size_t memoriaUtilizada() const {
+		return monticulo.capacity() * sizeof(unsigned int) + posicion.capacity() * sizeof(int)
+			+ claves.capacity() * sizeof(unsigned long);
+	}
+
+  private:
+
+	bool menor(unsigned int a, unsigned int b) const {
+		return claves[a] < claves[b] || (claves[a] == claves[b] && a < b);
+	}
+
+	void intercambiar(unsigned int i, unsigned int j) {
+		unsigned int a = monticulo[i];
+		monticulo[i] = monticulo[j];
+		monticulo[j] = a;
+		posicion[monticulo[i]] = i;
+		posicion[monticulo[j]] = j;
+	}
+
+	void subir(unsigned int i) {
+		while(i > 0 && menor(monticulo[i], monticulo[(i - 1) / 2])){
+			intercambiar(i, (i - 1) / 2);
+			i = (i - 1) / 2;
+		}
+	}
+
+	void bajar(unsigned int i) {
+		while(true){
+			unsigned int m = i;
+			unsigned int izq = 2 * i + 1;
+			if(izq < monticulo.size() && menor(monticulo[izq], monticulo[m])){
+				m = izq;
+			}
+			if(izq + 1 < monticulo.size() && menor(monticulo[izq + 1], monticulo[m])){
+				m = izq + 1;
+			}
+			if(m == i){
+				return;
+			}
+			intercambiar(i, m);
+			i = m;
+		}
+	}
+
+	vector<unsigned int> monticulo;
+	vector<int> posicion;
+	vector<unsigned long> claves;
+};
+
+/**
+ * Árbol de Fenwick de sumas sobre posiciones 0, 1, 2, ... que arrancan en 0
+ * y se agregan a medida que se fijan. Sirve para elegir una posición al azar
+ * con probabilidad proporcional a su valor en O(log n).
+ */
+class ArbolDeSumas {
+
+  public:
+
+	unsigned long total() const { return suma; }
+
+	unsigned long valor(unsigned int i) const { return i < valores.size() ? valores[i] : 0; }
+
+	void fijar(unsigned int i, unsigned long v) {
+		if(i >= valores.size()){
+			crecer(i + 1);
+		}
+		unsigned long antes = valores[i];
+		valores[i] = v;
+		suma = suma - antes + v;
+		for(unsigned int j = i + 1; j < arbol.size(); j += j & (0u - j)){
+			arbol[j] = arbol[j] - antes + v;
+		}
+	}
+
+	/**
+	 * Devuelve la posición i tal que la suma de las anteriores es <= r y la
+	 * suma hasta i inclusive es > r, y le resta a r la suma de las anteriores.
+	 * PRE: r < total()
+	 */
+	unsigned int buscar(unsigned long& r) const {
+		unsigned int n = arbol.size() - 1;
+		unsigned int paso = 1;
+		while(2 * paso <= n){
+			paso *= 2;
+		}
+		unsigned int pos = 0;
+		for(; paso > 0; paso /= 2){
+			if(pos + paso <= n && arbol[pos + paso] <= r){
+				pos += paso;
+				r -= arbol[pos];
+			}
+		}
+		return pos;
+	}
+
+	void vaciar() {
+		arbol.clear();
+		valores.clear();
+		suma = 0;
+	}
+
+	size_t memoriaUtilizada() const {
+		return (arbol.capacity() + valores.capacity()) * sizeof(unsigned long);
+	}
+
+	ArbolDeSumas() : suma(0) {}
+
+  private:
+
+	/**
+	 * Agranda el árbol (al menos al doble) y lo rearma en O(n).
+	 */
+	void crecer(unsigned int n) {
+		if(n < 2 * valores.size()){
+			n = 2 * valores.size();
+		}
+		valores.resize(n, 0);
+		arbol.assign(n + 1, 0);
+		for(unsigned int j = 1; j <= n; j++){
+			arbol[j] += valores[j - 1];
+			unsigned int padre = j + (j & (0u - j));
+			if(padre <= n){
+				arbol[padre] += arbol[j];
+			}
+		}
+	}
+
+	// arbol[j] suma las posiciones (j - lsb(j), j], con j desde 1
+	vector<unsigned long> arbol;
+	vector<unsigned long> valores;
+	unsigned long suma;
+};
+
+/**
+ * Cómo elige ejecutarSiguienteProceso al próximo proceso: en ronda, por
+ * lotería o por zancadas (ver PlanificadorRR::repartirPorLoteria).
+ */
+enum ModoDeReparto { REPARTO_RONDA, REPARTO_LOTERIA, REPARTO_ZANCADAS };
+
 /**
  * Se puede asumir que el tipo T tiene constructor por copia y operator==
  * No se puede asumir que el tipo T tenga operator=
@@ -36,9 +253,17 @@ class PlanificadorRR {
 	 * dentro del orden de ejecución, inmediatamente antes del que está
 	 * siendo ejecutado actualmente. Si no hubiese ningún proceso en ejecución,
 	 * la posición es arbitraria y el proceso pasa a ser ejecutado automáticamente.
+	 * Devuelve una manija para operar sobre el proceso en O(1).
+	 * PRE: El proceso no está siendo planificado por el planificador.
+	 */
+	Manija agregarProceso(const T&);
+
+	/**
+	 * Agrega un proceso al planificador como miembro del grupo indicado.
 	 * PRE: El proceso no está siendo planificado por el planificador.
+	 * PRE: El grupo fue creado con crearGrupo.
 	 */
-	void agregarProceso(const T&);
+	Manija agregarProceso(const T&, unsigned int grupo);
 
 	/**
 	 * Elimina un proceso del planificador. Si el proceso eliminado
@@ -99,17 +324,120 @@ class PlanificadorRR {
 	//  */
 	bool detenido() const;
 
+	/**
+	 * Modo diferido: mientras el planificador está detenido, agregarProceso,
+	 * eliminarProceso, pausarProceso y reanudarProceso no tocan el anillo sino
+	 * que se anotan en una cola, y reanudar() los aplica todos juntos en el
+	 * orden en que se pidieron. Al anotarlos se compactan por proceso: agregar
+	 * y después eliminar un mismo proceso se cancelan, lo mismo que pausar y
+	 * reanudar (o reanudar y pausar), y pausar o reanudar un proceso que se
+	 * agregó en la misma interrupción sólo cambia el estado con el que se
+	 * agrega. Mientras tanto las consultas ven el planificador como estaba
+	 * antes de la interrupción, y agregarProceso devuelve MANIJA_INVALIDA
+	 * porque el proceso todavía no está planificado.
+	 * Cada proceso sabe cuál es su cambio pendiente, así que anotar cuesta
+	 * O(1) con manija; por nombre cuesta buscarlo entre los agregados de la
+	 * interrupción y, si no está ahí, en el planificador.
+	 * Los grupos, los empalmes y ejecutarSiguienteProceso no se difieren.
+	 * Desactivar el modo aplica los cambios pendientes.
+	 */
+	void diferirCambios(bool);
+
+	/**
+	 * Informa si el modo diferido está activado.
+	 */
+	bool difiereCambios() const;
+
+	/**
+	 * Devuelve la cantidad de cambios anotados que quedan por aplicar, ya
+	 * compactados.
+	 */
+	int cantidadDeCambiosPendientes() const;
+
+	/**
+	 * Activa o desactiva el borrado diferido. Con el modo activado los
+	 * procesos nuevos se construyen en una arena de bloques contiguos en lugar
+	 * de pedirse uno por uno al heap, y al eliminar uno su lugar en la arena
+	 * queda como lápida: no se devuelve memoria en ese momento. Cuando las
+	 * lápidas pasan a ser más que los procesos vivos empieza una compactación
+	 * en segundo plano: cada agregarProceso y eliminarProceso muda unos pocos
+	 * procesos, en el orden de la ronda, a bloques nuevos, y cuando se mudaron
+	 * todos los bloques viejos se devuelven al heap. Las manijas siguen
+	 * valiendo después de mudar un proceso.
+	 * El proceso se saca del anillo en el momento, así que las consultas y la
+	 * ronda no ven las lápidas.
+	 */
+	void diferirBorrado(bool);
+
+	/**
+	 * Informa si el borrado diferido está activado.
+	 */
+	bool difiereBorrado() const;
+
+	/**
+	 * Devuelve la cantidad de lápidas que todavía ocupan lugar en la arena.
+	 */
+	int cantidadDeLapidas() const;
+
+	/**
+	 * Informa si hay una compactación en curso.
+	 */
+	bool estaCompactando() const;
+
+	/**
+	 * Conecta un canal por el que el planificador informa cada cambio que
+	 * aplica: agregar (con el grupo), eliminar, pausar, reanudar, ejecutar el
+	 * siguiente (con el nuevo ejecutado), detener y reanudar el planificador,
+	 * y frenar y liberar un proceso por su balde de fichas.
+	 * Repetir esos cambios sobre otro planificador en modo ronda lo deja
+	 * igual. Los demás cambios (grupos, plazos, boletos, reparto,
+	 * transferencias), o que el canal se llene, dejan una foto pendiente: el
+	 * planificador manda CAMBIO_FOTO y, en orden de ejecución a partir del
+	 * ejecutado, un CAMBIO_AGREGAR por proceso (con el grupo), un
+	 * CAMBIO_PAUSAR por cada uno que no se ejecuta (CAMBIO_FRENAR si es por
+	 * su balde) y CAMBIO_DETENER si está detenido. Mientras la foto no entra
+	 * en el canal no se manda ningún otro cambio: ya quedan en la foto.
+	 * Los cambios diferidos se informan cuando se aplican. Al conectar un
+	 * planificador con procesos se manda una foto. Con NULL se desconecta;
+	 * las copias del planificador no quedan conectadas.
+	 * PRE: el canal vive mientras esté conectado, este planificador es su
+	 * único productor y tiene lugar para la foto y la marca del hueco
+	 * (2 * cantidadDeProcesos() + 3 cambios alcanzan siempre).
+	 */
+	void conectarCanal(CanalDeCambios<T>*);
+
+	/**
+	 * Manda la foto pendiente si entra en el canal. Devuelve true si el
+	 * canal quedó al día. El productor la puede llamar cuando quiera (por
+	 * ejemplo, si se queda quieto después de que el canal se llenó).
+	 */
+	bool actualizarCanal();
+
 	// /**
 	//  * Informa si un cierto proceso está siendo planificado por el planificador.
 	//  */
 	bool esPlanificado(const T&) const; //CHEQUEAR
 
 	/**
-	 * Informa si un cierto proceso está activo en el planificador.
+	 * Informa si un cierto proceso está activo en el planificador, es decir,
+	 * si no está pausado ni él ni su grupo.
 	 * PRE: El proceso está siendo planificado por el planificador.
 	 */
 	bool estaActivo(const T&) const; //CHEQUEAR
 
+	/**
+	 * Versiones de esPlanificado, estaActivo y tienePlazo que buscan el
+	 * proceso por una clave de otro tipo (un id, un string_view con el
+	 * nombre) sin construir un T. El proceso buscado es el que da true al
+	 * compararlo con la clave mediante ==. Sólo participan si T == K existe.
+	 */
+	template<typename K>
+	typename SiEsClave<T, K, bool>::type esPlanificado(const K&) const;
+	template<typename K>
+	typename SiEsClave<T, K, bool>::type estaActivo(const K&) const;
+	template<typename K>
+	typename SiEsClave<T, K, bool>::type tienePlazo(const K&) const;
+
 	/**
 	 * Informa si existen procesos planificados.
 	 */
@@ -130,6 +458,208 @@ class PlanificadorRR {
 	 */
 	int cantidadDeProcesosActivos() const; //def
 
+	/**
+	 * Grupos de procesos: pausar o reanudar un grupo cambia una sola marca y
+	 * ajusta la cantidad de procesos activos en O(1). Los procesos de un
+	 * grupo pausado no se ejecutan (se muestran como inactivos) pero conservan
+	 * su propio estado: pausarProceso y reanudarProceso siguen valiendo sobre
+	 * ellos y se respetan al reanudar el grupo.
+	 * Los procesos agregados sin grupo no pertenecen a ninguno. Un proceso
+	 * que se mueve a otro planificador (transferirProcesos, unir, separar)
+	 * deja de pertenecer a su grupo.
+	 */
+
+	/**
+	 * Crea un grupo vacío y no pausado, y devuelve su número.
+	 */
+	unsigned int crearGrupo();
+
+	/**
+	 * Pausa todos los procesos del grupo. Si se estaba ejecutando uno de
+	 * ellos, pasa a ejecutarse el siguiente activo.
+	 * PRE: El grupo existe y no está pausado.
+	 */
+	void pausarGrupo(unsigned int grupo);
+
+	/**
+	 * Reanuda el grupo. Si no había ningún proceso en ejecución, pasa a
+	 * ejecutarse el siguiente activo.
+	 * PRE: El grupo existe y está pausado.
+	 */
+	void reanudarGrupo(unsigned int grupo);
+
+	/**
+	 * PRE: El grupo existe.
+	 */
+	bool grupoPausado(unsigned int grupo) const;
+
+	/**
+	 * Devuelve la cantidad de procesos del grupo.
+	 * PRE: El grupo existe.
+	 */
+	int cantidadDeProcesosDelGrupo(unsigned int grupo) const;
+
+	/**
+	 * Plazos (EDF): a un proceso se le puede asignar un plazo. Mientras haya
+	 * procesos activos con plazo, el que se ejecuta es el de plazo más próximo
+	 * (a igual plazo, uno cualquiera de ellos), procesoEjecutado lo devuelve y
+	 * mostrarPlanificadorRR empieza por él. Ese proceso sigue ejecutándose
+	 * hasta que se lo pausa, se lo elimina, se le cambia el plazo o aparece uno
+	 * con plazo más próximo; mientras tanto ejecutarSiguienteProceso no hace
+	 * nada. Cuando no queda ningún proceso activo con plazo se vuelve a la
+	 * ronda entre los procesos sin plazo, por donde había quedado.
+	 * Los procesos con plazo se guardan en un montículo indexado por grupo (y
+	 * los grupos no pausados en otro), así que pausar, reanudar, eliminar o
+	 * cambiar el plazo cuesta O(log n).
+	 */
+
+	/**
+	 * Reparto proporcional: cada proceso tiene boletos (1 al agregarlo). En
+	 * modo lotería ejecutarSiguienteProceso sortea el próximo proceso entre
+	 * los activos con probabilidad proporcional a sus boletos; en modo
+	 * zancadas cada proceso avanza un pase de ZANCADA / boletos cada vez que
+	 * se ejecuta y se elige siempre el de menor pase (a igual pase, el de
+	 * ranura menor), así que la proporción se cumple sin azar. Un proceso que
+	 * vuelve a estar activo arranca con el pase del último elegido; uno que
+	 * estuvo frenado, o al que se le cambian los boletos o el plazo, conserva
+	 * el suyo. Al reanudar un grupo los pases de sus procesos se corren todos
+	 * juntos lo necesario para que ninguno quede antes del último elegido.
+	 * Los boletos (o los pases) de los procesos activos se guardan por grupo
+	 * y los de los grupos no pausados en otra estructura, igual que los
+	 * plazos: elegir, pausar, reanudar, agregar, eliminar o cambiar los
+	 * boletos cuesta O(log n). Cambiar de modo cuesta O(n log n).
+	 * Los plazos tienen prioridad sobre el reparto, y al pausar o eliminar el
+	 * proceso en ejecución se pasa al siguiente de la ronda hasta el próximo
+	 * ejecutarSiguienteProceso.
+	 */
+	void repartirPorRonda();
+	void repartirPorLoteria(unsigned long long semilla);
+	void repartirPorZancadas();
+	ModoDeReparto reparto() const;
+
+	/**
+	 * Cambia los boletos del proceso.
+	 * PRE: El proceso está siendo planificado por el planificador.
+	 * PRE: 0 < boletos <= ZANCADA
+	 */
+	void asignarBoletos(const T&, unsigned int boletos);
+	void asignarBoletos(const Manija&, unsigned int boletos);
+
+	/**
+	 * PRE: El proceso está siendo planificado por el planificador.
+	 */
+	unsigned int boletos(const T&) const;
+
+	/**
+	 * Pase que avanza en una ejecución un proceso con un solo boleto.
+	 */
+	static const unsigned long ZANCADA = 1ul << 20;
+
+	/**
+	 * Limita cuántas veces se puede ejecutar el proceso con un balde de
+	 * fichas: el balde guarda hasta capacidad fichas, arranca lleno y recibe
+	 * una ficha cada periodo tics del reloj. Cada vez que
+	 * ejecutarSiguienteProceso elige al proceso le cobra una ficha, y si en
+	 * el próximo ejecutarSiguienteProceso el balde está vacío el proceso
+	 * queda frenado: no se ejecuta, como si estuviera pausado, hasta que le
+	 * llegue la próxima ficha. Frenar y pausar son independientes, y un
+	 * proceso frenado no está activo.
+	 * Los baldes no se recorren: cada uno guarda el tic en que va a estar
+	 * lleno y los frenados esperan en un montículo por el tic en que les
+	 * llega la ficha, así que cada tic cuesta O(1) más O(log n) por proceso
+	 * que se frena o se libera.
+	 * PRE: El proceso está siendo planificado por el planificador.
+	 * PRE: capacidad > 0 y periodo > 0
+	 */
+	void limitarEjecuciones(const T&, unsigned int capacidad, unsigned int periodo);
+	void limitarEjecuciones(const Manija&, unsigned int capacidad, unsigned int periodo);
+
+	/**
+	 * El proceso deja de tener límite (y de estar frenado).
+	 * PRE: El proceso está siendo planificado por el planificador.
+	 */
+	void quitarLimite(const T&);
+
+	/**
+	 * PRE: El proceso está siendo planificado por el planificador.
+	 */
+	bool estaFrenado(const T&) const;
+
+	/**
+	 * Tics transcurridos. Cada ejecutarSiguienteProceso avanza un tic.
+	 */
+	unsigned long reloj() const;
+
+	/**
+	 * Avanza el reloj sin ejecutar a nadie (por ejemplo, mientras no hay
+	 * procesos activos) y libera a los frenados que recibieron una ficha.
+	 */
+	void avanzarReloj(unsigned long tics);
+
+	/**
+	 * Asigna o cambia el plazo del proceso.
+	 * PRE: El proceso está siendo planificado por el planificador.
+	 */
+	void asignarPlazo(const T&, unsigned long plazo);
+	void asignarPlazo(const Manija&, unsigned long plazo);
+
+	/**
+	 * El proceso deja de tener plazo y vuelve a la ronda.
+	 * PRE: El proceso está siendo planificado por el planificador.
+	 */
+	void quitarPlazo(const T&);
+	void quitarPlazo(const Manija&);
+
+	/**
+	 * PRE: El proceso está siendo planificado por el planificador.
+	 */
+	bool tienePlazo(const T&) const;
+
+	/**
+	 * Versiones con manija de las operaciones anteriores: llegan al proceso
+	 * en O(1) en lugar de buscarlo en el anillo. Las manijas de procesos ya
+	 * eliminados dejan de ser válidas (también si se vuelve a agregar el
+	 * mismo proceso) y no valen en una copia del planificador.
+	 */
+
+	/**
+	 * Informa si la manija corresponde a un proceso planificado.
+	 */
+	bool esValida(const Manija&) const;
+
+	/**
+	 * Devuelve el proceso de la manija.
+	 * PRE: La manija es válida.
+	 */
+	const T& proceso(const Manija&) const;
+
+	/**
+	 * PRE: La manija es válida.
+	 */
+	void eliminarProceso(const Manija&);
+
+	/**
+	 * PRE: La manija es válida y el proceso está activo.
+	 */
+	void pausarProceso(const Manija&);
+
+	/**
+	 * PRE: La manija es válida y el proceso está inactivo.
+	 */
+	void reanudarProceso(const Manija&);
+
+	/**
+	 * PRE: La manija es válida.
+	 */
+	bool estaActivo(const Manija&) const;
+
+	/**
+	 * Devuelve la cantidad de bytes que ocupa el planificador: el objeto, sus
+	 * nodos y sus tablas auxiliares. No cuenta la memoria que use cada
+	 * proceso por fuera de su nodo.
+	 */
+	size_t memoriaUtilizada() const;
+
 	/**
 	 * Devuelve true si ambos planificadores son iguales.
 	 */
@@ -144,7 +674,8 @@ class PlanificadorRR {
 	 * pero estén todos pausados, se puede comenzar por cualquier proceso.
 	 * Un proceso inactivo debe ser identificado con el sufijo ' (i)'
 	 * y el proceso que está siendo ejecutado, de existir, debe ser identificado
-	 * con el sufijo '*'.
+	 * con el sufijo '*'. Un proceso frenado por su balde de fichas (y no
+	 * pausado) se identifica con el sufijo ' (f)'.
 	 * PlanificadorRR vacio: []
 	 * PlanificadorRR con 1 elemento activo: [p0*]
 	 * PlanificadorRR con 2 elementos inactivos: [p0 (i), p1 (i)]
@@ -156,6 +687,99 @@ class PlanificadorRR {
 	 */
 	ostream& mostrarPlanificadorRR(ostream&) const;
 
+	/**
+	 * Activa o desactiva el seguimiento de cambios para mostrarCambios. Al
+	 * activarlo el primer mostrarCambios pide redibujar todo. Las copias del
+	 * planificador no siguen cambios.
+	 */
+	void seguirCambios(bool);
+	bool sigueCambios() const;
+
+	/**
+	 * Muestra lo que cambió desde el mostrarCambios anterior, una línea por
+	 * cambio, con cada proceso en el mismo formato que mostrarPlanificadorRR:
+	 *   - p      el proceso p dejó de planificarse
+	 *   + p      se agregó el proceso p (p (i) si no se ejecuta)
+	 *   ~ p      p pasó a ejecutarse o dejó de hacerlo
+	 *   * p      p pasó a ser el ejecutado (* - si no queda ninguno activo)
+	 * Primero las bajas, después los procesos en el orden en que cambiaron
+	 * por primera vez y al final el ejecutado. Un proceso que se agregó y se
+	 * eliminó entre dos llamadas no aparece. Si hubo cambios que no se
+	 * describen así (grupos, transferencias, plazos, boletos, reparto) o se
+	 * juntaron demasiados, muestra sólo "!": hay que redibujar todo, por
+	 * ejemplo con mostrarPagina. El costo depende de los cambios, no de la
+	 * cantidad de procesos.
+	 * PRE: sigueCambios()
+	 */
+	ostream& mostrarCambios(ostream&);
+
+	/**
+	 * Muestra hasta cantidad procesos a partir del de la manija (del
+	 * ejecutado si es MANIJA_INVALIDA), con el formato de
+	 * mostrarPlanificadorRR, y devuelve la manija del proceso con el que
+	 * sigue la página siguiente, o MANIJA_INVALIDA si se llegó al final de la
+	 * vuelta. Juntando las páginas se obtiene lo mismo que con
+	 * mostrarPlanificadorRR, si el planificador no cambia entre una y otra.
+	 * PRE: cantidad > 0 y la manija es MANIJA_INVALIDA o es válida.
+	 */
+	Manija mostrarPagina(ostream&, const Manija& desde, unsigned int cantidad) const;
+
+	class const_iterator;
+	class Vista;
+
+	/**
+	 * Iteradores bidireccionales sobre los procesos planificados, en el mismo
+	 * orden en que los muestra mostrarPlanificadorRR (empezando por el que está
+	 * siendo ejecutado). Recorren el anillo en el lugar, sin copiar procesos.
+	 * Cualquier modificación del planificador invalida los iteradores.
+	 */
+	const_iterator begin() const;
+	const_iterator end() const;
+
+	/**
+	 * Vista de todos los procesos comenzando por el que está siendo ejecutado.
+	 */
+	Vista vistaDesdeEjecutado() const;
+
+	/**
+	 * Vista que recorre sólo los procesos activos, comenzando por el que está
+	 * siendo ejecutado.
+	 */
+	Vista vistaActivos() const;
+
+	/**
+	 * Saca de origen los cantidad procesos consecutivos (en orden de
+	 * ejecución) que empiezan en primero y los ubica, en el mismo orden,
+	 * inmediatamente antes del proceso en ejecución de este planificador.
+	 * Cada proceso conserva su estado. Si en origen se estaba ejecutando uno
+	 * de ellos, allá pasa a ejecutarse el siguiente activo; acá, si no había
+	 * ningún proceso en ejecución, pasa a ejecutarse el primero activo del arco.
+	 * Cuesta O(cantidad): el arco se corta y se enlaza con unos pocos
+	 * punteros, pero cada proceso movido se descuenta de origen y se registra
+	 * con una manija nueva. Las manijas de los procesos movidos dejan de valer.
+	 * Que los movidos no estén ya planificados acá no se verifica.
+	 * PRE: origen no es este planificador.
+	 * PRE: primero está planificado en origen y 0 < cantidad <= origen.cantidadDeProcesos().
+	 * PRE: ninguno de los procesos movidos está planificado en este planificador.
+	 */
+	void transferirProcesos(PlanificadorRR<T>& origen, const T& primero, unsigned int cantidad);
+	void transferirProcesos(PlanificadorRR<T>& origen, const Manija& primero, unsigned int cantidad);
+
+	/**
+	 * Mueve todos los procesos de otro a este planificador (comenzando por el
+	 * que se ejecuta en otro), como transferirProcesos. otro queda vacío.
+	 * PRE: otro no es este planificador y no comparten procesos.
+	 */
+	void unir(PlanificadorRR<T>& otro);
+
+	/**
+	 * Mueve a destino los procesos que cumplen el predicado, en orden de
+	 * ejecución, y los ubica antes del proceso en ejecución de destino.
+	 * PRE: destino no es este planificador y no planifica ninguno de los movidos.
+	 */
+	template<typename Predicado>
+	void separar(PlanificadorRR<T>& destino, Predicado cumple);
+
   private:
   
 	/**
@@ -169,174 +793,1807 @@ class PlanificadorRR {
 	/**
 	 * Aca va la implementación del nodo.
 	 */
+	/**
+	 * El nodo sólo tiene lo que usa la ronda: los enlaces, la ranura con las
+	 * marcas en sus bits altos, y el nombre. Para T de hasta 4 bytes ocupa
+	 * tres palabras. Lo de los demás modos (grupo, plazo, boletos, balde,
+	 * cambio pendiente) vive en tablas por ranura fuera del nodo.
+	 */
 	struct Nodo {
 		Nodo* sig;
 		Nodo* ant;
-		bool activo;
+		unsigned int ranura : 28;
+		unsigned int marca : 2;
+		unsigned int activo : 1;
+		unsigned int frenado : 1;
 		T nombre;
-		Nodo (const T& a) :nombre(a) , activo(true), sig(NULL), ant(NULL){};
+		Nodo (const T& a) : sig(NULL), ant(NULL), ranura(0), marca(LIMPIO), activo(true), frenado(false), nombre(a){};
 	};
 
-	unsigned int lon;
-	Nodo* ejec;
-	bool estado;
+	/**
+	 * Cantidad de ranuras que entran en los bits del nodo.
+	 */
+	static const unsigned int MAX_RANURAS = 1u << 28;
 
-};
+	/**
+	 * miembros y activos cuentan los procesos del grupo y, de ellos, los que
+	 * no están pausados individualmente.
+	 */
+	struct DatosGrupo {
+		bool pausado;
+		unsigned int miembros;
+		unsigned int activos;
+		// ranuras de los procesos activos con plazo, por plazo
+		MonticuloIndexado plazos;
+		// boletos o pases de los procesos activos, por ranura (según el reparto)
+		ArbolDeSumas boletos;
+		MonticuloIndexado pases;
+		// el pase de cada proceso es su clave en pases más desfase
+		unsigned long desfase;
+		DatosGrupo() : pausado(false), miembros(0), activos(0), desfase(0) {}
+	};
 
+	/**
+	 * Grupo de los procesos agregados sin grupo; nunca se pausa.
+	 */
+	static const unsigned int SIN_GRUPO = 0;
 
-template<typename T>
-PlanificadorRR<T>::PlanificadorRR(): lon(0), ejec(NULL), estado(true){}
+	/**
+	 * Plazo de los procesos que no tienen plazo.
+	 */
+	static const unsigned long SIN_PLAZO = ~0ul;
 
-template<typename T>
-PlanificadorRR<T>::PlanificadorRR(const PlanificadorRR<T>& proc){
-    int i = proc.lon;
-	if(i == 0){
-		lon = 0;
-		ejec = NULL;
-	}else{
-		lon = 0;
-		ejec = NULL;
-		Nodo* pcopiar = proc.ejec;
-		agregarProceso(pcopiar->nombre);
-		Nodo* nuevo = ejec;
+	/**
+	 * Devuelve el proceso que se está ejecutando: el de plazo más próximo si
+	 * hay alguno activo con plazo, o el de la ronda si no.
+	 */
+	Nodo* elegido() const;
+
+	/**
+	 * Pasa la ronda al siguiente proceso activo.
+	 * PRE: Hay al menos un proceso activo en el planificador.
+	 */
+	void avanzarRonda();
+
+	/**
+	 * Pone al grupo en el montículo de grupos con su plazo más próximo, o lo
+	 * saca si está pausado o no tiene procesos activos con plazo.
+	 */
+	void refrescarGrupo(unsigned int grupo);
+
+	void asignarPlazoANodo(Nodo*, unsigned long plazo);
+
+	/**
+	 * Suman o sacan al proceso activo de las estructuras del reparto de su
+	 * grupo, y actualizan las del grupo en las de todos los grupos.
+	 */
+	void entrarAlReparto(const Nodo*);
+	void salirDelReparto(const Nodo*);
+	void refrescarReparto(unsigned int grupo);
+
+	/**
+	 * Rearma las estructuras del reparto para el modo indicado.
+	 */
+	void cambiarReparto(ModoDeReparto);
+
+	/**
+	 * Elige el próximo proceso según el reparto.
+	 * PRE: Hay al menos un proceso activo y el modo no es en ronda.
+	 */
+	Nodo* sortear();
+	Nodo* menorPase();
+
+	/**
+	 * Baldes de fichas. tieneFicha dice si al proceso le queda una ficha en
+	 * el tic actual, cobrar le saca una y recarga es el tic en que le llega
+	 * la próxima.
+	 */
+	bool tieneFicha(const Nodo* n) const;
+	void cobrar(Nodo* n);
+	unsigned long recarga(const Nodo* n) const;
+
+	void frenar(Nodo* n);
+	void liberar(Nodo* n);
+
+	/**
+	 * Libera a los frenados cuya ficha llegó hasta el tic actual.
+	 */
+	void liberarFrenados();
+
+	/**
+	 * Cambio anotado en modo diferido. NADA marca los que se cancelaron; se
+	 * sacan de la cola cuando pasan a ser más que los vivos. Los cambios
+	 * sobre un proceso ya planificado guardan su manija.
+	 */
+	struct Pendiente {
+		enum Tipo { NADA, AGREGAR, ELIMINAR, PAUSAR, REANUDAR };
+		Tipo tipo;
+		bool activo;
+		unsigned int grupo;
+		Manija manija;
+		T nombre;
+		Pendiente(Tipo t, const T& n, unsigned int g, const Manija& m) : tipo(t), activo(true), grupo(g), manija(m), nombre(n) {}
+	};
+
+	/**
+	 * Nodo sin cambio pendiente.
+	 */
+	static const unsigned int SIN_PENDIENTE = ~0u;
+
+	/**
+	 * Balde de fichas de un proceso: sin límite si la capacidad es 0. pase es
+	 * el pase por zancadas con el que vuelve al reparto cuando deja de estar
+	 * frenado.
+	 */
+	struct Balde {
+		unsigned long llenoEn;
+		unsigned long pase;
+		unsigned int capacidad;
+		unsigned int periodo;
+		Balde() : llenoEn(0), pase(0), capacidad(0), periodo(0) {}
+	};
+
+	/**
+	 * Estado de los plazos, del reparto por lotería o zancadas, de los baldes
+	 * y del modo diferido. Cada uno se crea la primera vez que se usa, así un
+	 * planificador en ronda no paga por los demás. Las tablas por ranura se
+	 * agrandan cuando hace falta: una ranura que no alcanzan tiene el valor
+	 * por defecto.
+	 */
+	struct EstadoPlazos {
+		// plazo de cada proceso, por ranura
+		vector<unsigned long> plazos;
+		// grupos no pausados con procesos activos con plazo, por su plazo más próximo
+		MonticuloIndexado gruposConPlazo;
+	};
+
+	struct EstadoReparto {
+		// boletos de cada proceso, por ranura
+		vector<unsigned int> boletos;
+		// boletos de cada grupo no pausado, o grupos no pausados por su menor pase
+		ArbolDeSumas boletosPorGrupo;
+		MonticuloIndexado gruposPorPase;
+		GeneradorAzar azar;
+		unsigned long paseGlobal;
+		EstadoReparto() : azar(1, 0), paseGlobal(0) {}
+	};
+
+	struct EstadoBaldes {
+		// balde de cada proceso, por ranura
+		vector<Balde> baldes;
+		// procesos frenados, por ranura, según el tic en que les llega una ficha
+		MonticuloIndexado frenados;
+	};
+
+	struct EstadoDiferido {
+		// índice en pendientes del cambio de cada proceso, por ranura
+		vector<unsigned int> pendientePorRanura;
+		vector<Pendiente> pendientes;
+		unsigned int vivos;
+		// índices en pendientes de los AGREGAR, en orden
+		vector<unsigned int> agregados;
+		EstadoDiferido() : vivos(0) {}
+	};
+
+	/**
+	 * Devuelven el estado del modo, y lo crean si todavía no existe.
+	 */
+	EstadoPlazos& usarPlazos() {
+		if(estadoPlazos == NULL){
+			estadoPlazos = new EstadoPlazos();
+		}
+		return *estadoPlazos;
+	}
+	EstadoReparto& usarReparto() {
+		if(estadoReparto == NULL){
+			estadoReparto = new EstadoReparto();
+		}
+		return *estadoReparto;
+	}
+	EstadoBaldes& usarBaldes() {
+		if(estadoBaldes == NULL){
+			estadoBaldes = new EstadoBaldes();
+		}
+		return *estadoBaldes;
+	}
+	EstadoDiferido& usarDiferido() {
+		if(estadoDiferido == NULL){
+			estadoDiferido = new EstadoDiferido();
+		}
+		return *estadoDiferido;
+	}
+
+	/**
+	 * Leen y escriben una tabla por ranura. Escribir el valor por defecto en
+	 * una ranura que la tabla no alcanza no la agranda.
+	 */
+	template<typename V>
+	static V leerRanura(const vector<V>& tabla, unsigned int r, V porDefecto) {
+		return r < tabla.size() ? tabla[r] : porDefecto;
+	}
+	template<typename V>
+	static void escribirRanura(vector<V>& tabla, unsigned int r, V v, V porDefecto) {
+		if(r >= tabla.size()){
+			if(v == porDefecto){
+				return;
+			}
+			tabla.resize(r + 1, porDefecto);
+		}
+		tabla[r] = v;
+	}
+
+	unsigned int grupoDe(const Nodo* n) const { return leerRanura(grupoPorRanura, n->ranura, SIN_GRUPO); }
+	unsigned long plazoDe(const Nodo* n) const { return estadoPlazos == NULL ? SIN_PLAZO : leerRanura(estadoPlazos->plazos, n->ranura, SIN_PLAZO); }
+	unsigned int boletosDe(const Nodo* n) const { return estadoReparto == NULL ? 1 : leerRanura(estadoReparto->boletos, n->ranura, 1u); }
+	unsigned int pendienteDe(const Nodo* n) const { return estadoDiferido == NULL ? SIN_PENDIENTE : leerRanura(estadoDiferido->pendientePorRanura, n->ranura, SIN_PENDIENTE); }
+
+	/**
+	 * Balde del proceso, o NULL si nunca se le puso un límite.
+	 */
+	Balde* baldeDe(const Nodo* n) const {
+		return estadoBaldes != NULL && n->ranura < estadoBaldes->baldes.size() ? &estadoBaldes->baldes[n->ranura] : NULL;
+	}
+
+	/**
+	 * Informa si hay algún grupo no pausado con procesos activos con plazo.
+	 */
+	bool hayPlazos() const { return estadoPlazos != NULL && !estadoPlazos->gruposConPlazo.vacio(); }
+
+	/**
+	 * Todo lo que se sabe de un proceso además de su nombre, sus enlaces y su
+	 * ranura. Sirve para llevarlo a otro nodo o a otro planificador.
+	 */
+	struct EstadoProceso {
+		bool activo;
+		bool frenado;
+		unsigned int marca;
+		unsigned int grupo;
+		unsigned long plazo;
+		unsigned int boletos;
+		unsigned int pendiente;
+		bool conBalde;
+		Balde balde;
+		EstadoProceso() : activo(true), frenado(false), marca(LIMPIO), grupo(SIN_GRUPO), plazo(SIN_PLAZO), boletos(1), pendiente(SIN_PENDIENTE), conBalde(false) {}
+	};
+
+	EstadoProceso estadoDe(const Nodo*) const;
+
+	/**
+	 * Le da al nodo, ya registrado, el estado indicado.
+	 */
+	void copiarEstado(Nodo* destino, const EstadoProceso&);
+
+	/**
+	 * Registra el nodo en una ranura libre. La ranura puede haber sido de un
+	 * proceso eliminado, así que el nodo arranca con el estado por defecto.
+	 */
+	Manija registrarNodo(Nodo*);
+
+	/**
+	 * Informa si los cambios se tienen que anotar en lugar de aplicarse.
+	 */
+	bool difiriendo() const { return diferir && !estado; }
+
+	/**
+	 * Anotan un cambio, compactándolo con el cambio pendiente del mismo
+	 * proceso si lo hay. El proceso se busca primero entre los agregados en
+	 * esta interrupción (el más nuevo primero) y después en el planificador.
+	 * PRE: el tipo no es AGREGAR ni NADA.
+	 */
+	void anotar(typename Pendiente::Tipo, const T&);
+	void anotar(typename Pendiente::Tipo, Nodo*);
+
+	/**
+	 * Anota agregar un proceso; nunca se compacta con uno anterior.
+	 */
+	void anotarAgregado(const T&, unsigned int grupo);
+
+	/**
+	 * Compacta el cambio nuevo con el pendiente de índice i.
+	 */
+	void compactarPendiente(unsigned int i, typename Pendiente::Tipo);
+
+	/**
+	 * Cancela el cambio pendiente de índice i y, si los cancelados pasan a
+	 * ser más que los vivos, los saca de la cola.
+	 */
+	void cancelarPendiente(unsigned int i);
+
+	/**
+	 * Aplica y vacía la cola de cambios pendientes.
+	 */
+	void aplicarPendientes();
+
+	/**
+	 * Un proceso se ejecuta si está activo y su grupo no está pausado.
+	 */
+	bool ejecutable(const Nodo* n) const { return disponible(n) && !grupos[grupoDe(n)].pausado; }
+
+	/**
+	 * Un proceso cuenta como activo en su grupo si no está pausado ni frenado.
+	 */
+	bool disponible(const Nodo* n) const { return n->activo && !n->frenado; }
+
+	/**
+	 * Suman o restan al nodo en la cuenta de procesos activos y en la de su grupo.
+	 */
+	void contarAlta(const Nodo*);
+	void contarBaja(const Nodo*);
+
+	/**
+	 * Pase por zancadas del proceso, o el del último elegido si no está en el
+	 * reparto por zancadas.
+	 */
+	unsigned long paseDe(const Nodo*) const;
+
+	/**
+	 * Le devuelve al proceso un pase que tenía (o el del último elegido, si
+	 * es mayor). No hace nada si no está en el reparto por zancadas.
+	 */
+	void fijarPase(const Nodo*, unsigned long pase);
+
+	/**
+	 * El proceso paga el turno que usó: su pase avanza ZANCADA / boletos.
+	 * PRE: el proceso está en el reparto por zancadas.
+	 */
+	void pagarPase(const Nodo*);
+
+	/**
+	 * Devuelve el nodo del proceso (o del que es igual a la clave), o NULL
+	 * si no está planificado.
+	 */
+	template<typename K>
+	Nodo* buscar(const K&) const;
+
+	/**
+	 * Saca al nodo del anillo, libera su ranura y lo borra.
+	 */
+	void quitarNodo(Nodo*);
+
+	/**
+	 * Crean y borran nodos en la arena o en el heap según el modo de borrado.
+	 * liberarNodo arranca la compactación si hay demasiadas lápidas.
+	 */
+	Nodo* nuevoNodo(const T&);
+	void liberarNodo(Nodo*);
+
+	/**
+	 * Muda unos pocos nodos de la compactación en curso.
+	 */
+	void compactarPaso();
+
+	/**
+	 * Reemplaza al nodo por una copia en la generación actual de la arena,
+	 * en el mismo lugar del anillo y con la misma ranura.
+	 */
+	void reubicar(Nodo*);
+
+	/**
+	 * Saca al nodo del anillo sin liberarlo. Si era el ejecutado pasa a
+	 * ejecutarse el siguiente activo.
+	 */
+	void desenlazar(Nodo*);
+
+	/**
+	 * Corta del anillo el arco de cantidad nodos que empieza en primero y lo
+	 * deja como una cadena abierta.
+	 */
+	void cortarArco(Nodo* primero, unsigned int cantidad);
+
+	/**
+	 * Toma una cadena abierta de cantidad nodos sacados de origen: libera sus
+	 * ranuras allá, las registra acá y la enlaza antes del ejecutado. Los
+	 * nodos que viven en la arena de origen se copian.
+	 */
+	void adoptarCadena(PlanificadorRR<T>& origen, Nodo* primero, unsigned int cantidad);
+
+	void pausarNodo(Nodo*);
+	void reanudarNodo(Nodo*);
+
+	/**
+	 * Informa un cambio por el canal, si hay uno conectado.
+	 */
+	void informar(TipoDeCambio tipo);
+	void informar(TipoDeCambio tipo, Nodo* n, long valor);
+
+	/**
+	 * Manda el cambio por el canal, antes la foto pendiente si hay una. Si
+	 * el cambio ya se aplicó y la foto salió recién, no hace falta mandarlo.
+	 */
+	void emitir(const Cambio<T>&, bool yaAplicado);
+
+	/**
+	 * Marcas de los nodos para mostrarCambios.
+	 */
+	enum Marca { LIMPIO, NUEVO, CAMBIADO };
+
+	/**
+	 * Anota el nodo para el próximo mostrarCambios, si no estaba anotado.
+	 */
+	void marcar(Nodo* n, Marca m);
+
+	/**
+	 * Descarta lo anotado: el próximo mostrarCambios pide redibujar todo.
+	 */
+	void desbordar();
+
+	/**
+	 * Muestra el proceso del nodo como mostrarPlanificadorRR, sin el *.
+	 */
+	void mostrarProceso(ostream& os, const Nodo* n) const;
+
+	TablaDeManijas<Nodo> manijas;
+	unsigned int lon;
+	Nodo* ejec;
+	bool estado;
+	vector<DatosGrupo> grupos;
+	// grupo de cada proceso, por ranura; vacía mientras nadie tenga grupo
+	vector<unsigned int> grupoPorRanura;
+	ModoDeReparto modo;
+	unsigned long ahora;
+	unsigned int activos;
+	bool diferir;
+	// estado de cada modo, o NULL si nunca se usó
+	EstadoPlazos* estadoPlazos;
+	EstadoReparto* estadoReparto;
+	EstadoBaldes* estadoBaldes;
+	EstadoDiferido* estadoDiferido;
+	ArenaNodos<Nodo> arena;
+	bool borradoDiferido;
+	// próximo nodo a mudar, o NULL si no se está compactando
+	Nodo* compactando;
+	CanalDeCambios<T>* canal;
+	bool fotoPendiente;
+	// seguimiento de cambios para mostrarCambios
+	bool siguiendo;
+	bool desbordado;
+	vector<Manija> sucios;
+	vector<T> quitados;
+	Manija elegidoMostrado;
+
+  public:
+
+	/**
+	 * Recorre el anillo a partir de un nodo. Lleva la cuenta de los pasos
+	 * dados para distinguir el final de la vuelta del comienzo.
+	 */
+	class const_iterator {
+	  public:
+		typedef std::bidirectional_iterator_tag iterator_category;
+		typedef T value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const T* pointer;
+		typedef const T& reference;
+
+		const_iterator() : plan(NULL), nodo(NULL), pasos(0), soloActivos(false) {}
+
+		reference operator*() const { return nodo->nombre; }
+		pointer operator->() const { return &(nodo->nombre); }
+
+		/**
+		 * Informa si el proceso apuntado está activo.
+		 */
+		bool activo() const { return plan->ejecutable(nodo); }
+
+		/**
+		 * Informa si el proceso apuntado es el que está siendo ejecutado.
+		 */
+		bool ejecutado() const { return nodo == plan->elegido() && plan->ejecutable(nodo); }
+
+		/**
+		 * Manija del proceso apuntado.
+		 */
+		Manija manija() const { return plan->manijas.manija(nodo->ranura); }
+
+		const_iterator& operator++() {
+			do {
+				nodo = nodo->sig;
+				pasos++;
+			} while(soloActivos && pasos < plan->lon && !plan->ejecutable(nodo));
+			return *this;
+		}
+		const_iterator operator++(int) { const_iterator res(*this); ++(*this); return res; }
+
+		const_iterator& operator--() {
+			do {
+				nodo = nodo->ant;
+				pasos--;
+			} while(soloActivos && pasos > 0 && !plan->ejecutable(nodo));
+			return *this;
+		}
+		const_iterator operator--(int) { const_iterator res(*this); --(*this); return res; }
+
+		bool operator==(const const_iterator& otro) const { return nodo == otro.nodo && pasos == otro.pasos; }
+		bool operator!=(const const_iterator& otro) const { return !(*this == otro); }
+
+	  private:
+		friend class PlanificadorRR<T>;
+		const_iterator(const PlanificadorRR<T>* p, const Nodo* n, unsigned int i, bool s)
+			: plan(p), nodo(n), pasos(i), soloActivos(s) {}
+
+		const PlanificadorRR<T>* plan;
+		const Nodo* nodo;
+		unsigned int pasos;
+		bool soloActivos;
+	};
+
+	/**
+	 * Par de iteradores liviano (no es dueño de ningún proceso).
+	 */
+	class Vista {
+	  public:
+		const_iterator begin() const { return inicio; }
+		const_iterator end() const { return fin; }
+		bool empty() const { return inicio == fin; }
+
+	  private:
+		friend class PlanificadorRR<T>;
+		Vista(const const_iterator& i, const const_iterator& f) : inicio(i), fin(f) {}
+
+		const_iterator inicio;
+		const_iterator fin;
+	};
+
+};
+
+
+template<typename T>
+PlanificadorRR<T>::PlanificadorRR(): lon(0), ejec(NULL), estado(true), grupos(1), modo(REPARTO_RONDA), ahora(0), activos(0), diferir(false), estadoPlazos(NULL), estadoReparto(NULL), estadoBaldes(NULL), estadoDiferido(NULL), borradoDiferido(false), compactando(NULL), canal(NULL), fotoPendiente(false), siguiendo(false), desbordado(false), elegidoMostrado(MANIJA_INVALIDA){}
+
+template<typename T>
+PlanificadorRR<T>::PlanificadorRR(const PlanificadorRR<T>& proc): lon(0), ejec(NULL), estado(proc.estado), grupos(proc.grupos), modo(proc.modo), ahora(proc.ahora), activos(0), diferir(proc.diferir), estadoPlazos(NULL), estadoReparto(NULL), estadoBaldes(NULL), estadoDiferido(NULL), borradoDiferido(proc.borradoDiferido), compactando(NULL), canal(NULL), fotoPendiente(false), siguiendo(false), desbordado(false), elegidoMostrado(MANIJA_INVALIDA){
+	// las cuentas de los grupos se rehacen a medida que se copian los procesos
+	for(unsigned int g = 0; g < grupos.size(); g++){
+		grupos[g].miembros = 0;
+		grupos[g].activos = 0;
+		grupos[g].plazos.vaciar();
+		grupos[g].boletos.vaciar();
+		grupos[g].pases.vaciar();
+	}
+	// los modos que usa el original; sus tablas se llenan al copiar los procesos
+	if(proc.estadoPlazos != NULL){
+		usarPlazos();
+	}
+	if(proc.estadoReparto != NULL){
+		usarReparto().azar = proc.estadoReparto->azar;
+		estadoReparto->paseGlobal = proc.estadoReparto->paseGlobal;
+	}
+	if(proc.estadoBaldes != NULL){
+		usarBaldes();
+	}
+	if(proc.estadoDiferido != NULL){
+		estadoDiferido = new EstadoDiferido(*proc.estadoDiferido);
+		estadoDiferido->pendientePorRanura.clear();
+	}
+	Nodo* pcopiar = proc.ejec;
+	Nodo* ultimo = NULL;
+	for(unsigned int i = 0; i < proc.lon; i++){
+		Nodo* nuevo = nuevoNodo(pcopiar->nombre);
+		Manija m = registrarNodo(nuevo);
+		EstadoProceso e = proc.estadoDe(pcopiar);
+		// la copia no sigue los cambios del original
+		e.marca = LIMPIO;
+		copiarEstado(nuevo, e);
+		// el cambio pendiente pasa a referirse a la copia
+		if(e.pendiente != SIN_PENDIENTE){
+			estadoDiferido->pendientes[e.pendiente].manija = m;
+		}
+		if(nuevo->frenado){
+			estadoBaldes->frenados.insertar(nuevo->ranura, recarga(nuevo));
+		}
+		contarAlta(nuevo);
+		// el pase por zancadas es la clave en el montículo del grupo: se copia
+		// tal cual, junto con el desfase del grupo
+		if(modo == REPARTO_ZANCADAS && disponible(nuevo)){
+			grupos[e.grupo].pases.cambiar(nuevo->ranura, proc.grupos[e.grupo].pases.clave(pcopiar->ranura));
+			refrescarReparto(e.grupo);
+		}
+		if(ultimo == NULL){
+			ejec = nuevo;
+		}else{
+			ultimo->sig = nuevo;
+			nuevo->ant = ultimo;
+		}
+		ultimo = nuevo;
 		pcopiar = pcopiar->sig;
-		while(pcopiar != proc.ejec){
-				agregarProceso(pcopiar->nombre);
-				pcopiar = pcopiar->sig;
-				nuevo = nuevo->sig;
-				if(pcopiar->ant->activo == false){
-					nuevo->activo = false;
+	}
+	if(ultimo != NULL){
+		ultimo->sig = ejec;
+		ejec->ant = ultimo;
+	}
+	lon = proc.lon;
+}
+
+template<typename T>
+PlanificadorRR<T>::~PlanificadorRR(){
+	// que borrar no arranque una compactación
+	borradoDiferido = false;
+	canal = NULL;
+	Nodo* ite = ejec;
+	for(unsigned int i = 0; i < lon; i++){
+		Nodo* sig = ite->sig;
+		liberarNodo(ite);
+		ite = sig;
+	}
+	delete estadoPlazos;
+	delete estadoReparto;
+	delete estadoBaldes;
+	delete estadoDiferido;
+}
+
+template<typename T>
+Manija PlanificadorRR<T>::agregarProceso(const T& nom){
+	return agregarProceso(nom, SIN_GRUPO);
+}
+
+template<typename T>
+Manija PlanificadorRR<T>::agregarProceso(const T& nom, unsigned int grupo){
+	assert(grupo < grupos.size());
+	if(difiriendo()){
+		anotarAgregado(nom, grupo);
+		return MANIJA_INVALIDA;
+	}
+	assert(esPlanificado(nom) == false);
+	Nodo* nuevo = nuevoNodo(nom);
+	Manija m = registrarNodo(nuevo);
+	escribirRanura(grupoPorRanura, nuevo->ranura, grupo, SIN_GRUPO);
+	contarAlta(nuevo);
+	if(lon == 0){
+		nuevo->sig = nuevo;
+		nuevo->ant = nuevo;
+		ejec = nuevo;
+	}else{
+			Nodo* ejecutado = ejec;
+			nuevo->ant = ejec->ant;
+			nuevo->sig = ejec;
+			ejecutado->ant->sig = nuevo;
+			ejecutado->ant = nuevo;
+				if(!ejecutable(ejecutado) && ejecutable(nuevo)){
+					ejec = nuevo;
 				}
+			}
+	lon++;
+	informar(CAMBIO_AGREGAR, nuevo, grupo);
+	compactarPaso();
+	return m;
+}
+
+
+template<typename T>
+void PlanificadorRR<T>::eliminarProceso(const T& procAelim){
+	if(difiriendo()){
+		anotar(Pendiente::ELIMINAR, procAelim);
+		return;
+	}
+	Nodo* iterador = buscar(procAelim);
+	assert(iterador != NULL);
+	informar(CAMBIO_ELIMINAR, iterador, 0);
+	quitarNodo(iterador);
+	compactarPaso();
+}
+
+template<typename T>
+void PlanificadorRR<T>::eliminarProceso(const Manija& m){
+	Nodo* iterador = manijas.resolver(m);
+	assert(iterador != NULL);
+	if(difiriendo()){
+		anotar(Pendiente::ELIMINAR, iterador);
+		return;
+	}
+	informar(CAMBIO_ELIMINAR, iterador, 0);
+	quitarNodo(iterador);
+	compactarPaso();
+}
+
+template<typename T>
+void PlanificadorRR<T>::quitarNodo(Nodo* iterador){
+	manijas.liberar(iterador->ranura);
+	desenlazar(iterador);
+	liberarNodo(iterador);
+}
+
+template<typename T>
+typename PlanificadorRR<T>::Nodo* PlanificadorRR<T>::nuevoNodo(const T& nom){
+	if(borradoDiferido){
+		return arena.crear(nom);
+	}
+	return crearNodo<Nodo>(nom);
+}
+
+template<typename T>
+void PlanificadorRR<T>::liberarNodo(Nodo* n){
+	if(!arena.esPropio(n)){
+		destruirNodo(n);
+		return;
+	}
+	arena.destruir(n);
+	if(borradoDiferido && compactando == NULL && lon > 0 && arena.lapidas() > max<size_t>(16, arena.vivos())){
+		arena.nuevaGeneracion();
+		compactando = ejec;
+	}
+}
+
+template<typename T>
+void PlanificadorRR<T>::compactarPaso(){
+	for(int i = 0; i < 4 && compactando != NULL; i++){
+		Nodo* n = compactando;
+		compactando = n->sig;
+		if(!arena.esNuevo(n)){
+			reubicar(n);
+		}
+		if(lon == arena.vivos()){
+			compactando = NULL;
+		}
+	}
+}
+
+template<typename T>
+void PlanificadorRR<T>::reubicar(Nodo* n){
+	Nodo* m = arena.crear(n->nombre);
+	m->ranura = n->ranura;
+	copiarEstado(m, estadoDe(n));
+	if(n->sig == n){
+		m->sig = m;
+		m->ant = m;
+	}else{
+		m->sig = n->sig;
+		m->ant = n->ant;
+		n->ant->sig = m;
+		n->sig->ant = m;
+	}
+	manijas.reubicar(m->ranura, m);
+	if(ejec == n){
+		ejec = m;
+	}
+	if(compactando == n){
+		compactando = m;
+	}
+	liberarNodo(n);
+}
+
+template<typename T>
+typename PlanificadorRR<T>::EstadoProceso PlanificadorRR<T>::estadoDe(const Nodo* n) const{
+	EstadoProceso e;
+	e.activo = n->activo;
+	e.frenado = n->frenado;
+	e.marca = n->marca;
+	e.grupo = grupoDe(n);
+	e.plazo = plazoDe(n);
+	e.boletos = boletosDe(n);
+	e.pendiente = pendienteDe(n);
+	const Balde* b = baldeDe(n);
+	if(b != NULL && b->capacidad != 0){
+		e.conBalde = true;
+		e.balde = *b;
+	}
+	return e;
+}
+
+template<typename T>
+void PlanificadorRR<T>::copiarEstado(Nodo* destino, const EstadoProceso& e){
+	unsigned int r = destino->ranura;
+	destino->activo = e.activo;
+	destino->frenado = e.frenado;
+	destino->marca = e.marca;
+	escribirRanura(grupoPorRanura, r, e.grupo, SIN_GRUPO);
+	// las tablas de un modo que no se usa no se crean para guardar el valor por defecto
+	if(e.plazo != SIN_PLAZO || estadoPlazos != NULL){
+		escribirRanura(usarPlazos().plazos, r, e.plazo, SIN_PLAZO);
+	}
+	if(e.boletos != 1 || estadoReparto != NULL){
+		escribirRanura(usarReparto().boletos, r, e.boletos, 1u);
+	}
+	if(e.pendiente != SIN_PENDIENTE || estadoDiferido != NULL){
+		escribirRanura(usarDiferido().pendientePorRanura, r, e.pendiente, SIN_PENDIENTE);
+	}
+	if(e.conBalde){
+		vector<Balde>& baldes = usarBaldes().baldes;
+		if(r >= baldes.size()){
+			baldes.resize(r + 1);
+		}
+		baldes[r] = e.balde;
+	}else if(baldeDe(destino) != NULL){
+		*baldeDe(destino) = Balde();
+	}
+}
+
+template<typename T>
+Manija PlanificadorRR<T>::registrarNodo(Nodo* n){
+	Manija m = manijas.registrar(n);
+	assert(m.ranura < MAX_RANURAS);
+	n->ranura = m.ranura;
+	copiarEstado(n, EstadoProceso());
+	return m;
+}
+
+template<typename T>
+void PlanificadorRR<T>::desenlazar(Nodo* iterador){
+	contarBaja(iterador);
+	if(iterador->frenado){
+		estadoBaldes->frenados.quitar(iterador->ranura);
+		iterador->frenado = false;
+	}
+	bool eraEjecutado = false;
+	if(iterador == compactando){
+		compactando = lon == 1 ? NULL : iterador->sig;
+	}
+	if(lon != 1){
+		eraEjecutado = (iterador == ejec);
+		if(eraEjecutado){
+			ejec = iterador->sig;
+		}
+		iterador->ant->sig = iterador->sig;
+		iterador->sig->ant = iterador->ant;
+	}else{
+		ejec = NULL;
+	}
+	lon--;
+	// si el que sigue está pausado, pasa a ejecutarse el siguiente activo
+	if(eraEjecutado && !ejecutable(ejec) && hayProcesosActivos()){
+		avanzarRonda();
+	}
+}
+
+template<typename T>
+const T& PlanificadorRR<T>::procesoEjecutado() const{
+	assert(hayProcesosActivos() == true);
+	return elegido()->nombre;
+}
+
+template<typename T>
+void PlanificadorRR<T>::ejecutarSiguienteProceso(){
+	assert(hayProcesosActivos());
+	ahora++;
+	liberarFrenados();
+	// el que se ejecutó con su última ficha queda frenado
+	Nodo* actual = elegido();
+	if(ejecutable(actual) && !tieneFicha(actual)){
+		frenar(actual);
+		if(!hayProcesosActivos()){
+			return;
+		}
+	}
+	// un proceso con plazo sigue ejecutándose hasta que deje de ser el elegido
+	if(!hayPlazos()){
+		if(modo == REPARTO_LOTERIA){
+			ejec = sortear();
+		}else if(modo == REPARTO_ZANCADAS){
+			ejec = menorPase();
+		}else{
+			avanzarRonda();
+		}
+	}else if(!ejecutable(ejec)){
+		// el frenado era el de la ronda: la ronda sigue con el próximo
+		avanzarRonda();
+	}
+	cobrar(elegido());
+	informar(CAMBIO_EJECUTAR, elegido(), 0);
+}
+
+template<typename T>
+typename PlanificadorRR<T>::Nodo* PlanificadorRR<T>::elegido() const{
+	if(!hayPlazos()){
+		return ejec;
+	}
+	return manijas.nodoEn(grupos[estadoPlazos->gruposConPlazo.minimo()].plazos.minimo());
+}
+
+template<typename T>
+void PlanificadorRR<T>::avanzarRonda(){
+	assert(hayProcesosActivos());
+	Nodo* iterador = ejec->sig;
+	int i = lon;
+	bool c = true;
+	while(i > 1 && c){  
+		if(ejecutable(iterador)){
+			c = false; 
+		}else{
+		i--;
+		iterador = iterador->sig;
+		}
+	}
+	ejec = iterador;
+}
+
+template<typename T>
+void PlanificadorRR<T>::pausarProceso(const T& nom){
+	if(difiriendo()){
+		anotar(Pendiente::PAUSAR, nom);
+		return;
+	}
+	Nodo* ite = buscar(nom);
+	assert(ite != NULL);
+	pausarNodo(ite);
+}
+
+template<typename T>
+void PlanificadorRR<T>::pausarProceso(const Manija& m){
+	Nodo* ite = manijas.resolver(m);
+	assert(ite != NULL);
+	if(difiriendo()){
+		anotar(Pendiente::PAUSAR, ite);
+		return;
+	}
+	pausarNodo(ite);
+}
+
+template<typename T>
+void PlanificadorRR<T>::pausarNodo(Nodo* ite){
+	contarBaja(ite);
+	ite->activo = false;
+	contarAlta(ite);
+	informar(CAMBIO_PAUSAR, ite, 0);
+	if(ejec == ite){
+		if(hayProcesosActivos()){
+			avanzarRonda();
+		}
+	}
+}
+
+template<typename T>
+void PlanificadorRR<T>::reanudarProceso(const T& nom){
+	if(difiriendo()){
+		anotar(Pendiente::REANUDAR, nom);
+		return;
+	}
+	Nodo* ite = buscar(nom);
+	assert(ite != NULL);
+	reanudarNodo(ite);
+}
+
+template<typename T>
+void PlanificadorRR<T>::reanudarProceso(const Manija& m){
+	Nodo* ite = manijas.resolver(m);
+	assert(ite != NULL);
+	if(difiriendo()){
+		anotar(Pendiente::REANUDAR, ite);
+		return;
+	}
+	reanudarNodo(ite);
+}
+
+template<typename T>
+void PlanificadorRR<T>::reanudarNodo(Nodo* ite){
+	contarBaja(ite);
+	ite->activo = true;
+	contarAlta(ite);
+	informar(CAMBIO_REANUDAR, ite, 0);
+	if(!ejecutable(ejec) && ejecutable(ite)){
+		ejec = ite;
+	}
+
+}
+
+template<typename T>
+void PlanificadorRR<T>::contarAlta(const Nodo* n){
+	unsigned int g = grupoDe(n);
+	grupos[g].miembros++;
+	if(disponible(n)){
+		grupos[g].activos++;
+		entrarAlReparto(n);
+		unsigned long plazo = plazoDe(n);
+		if(plazo != SIN_PLAZO){
+			grupos[g].plazos.insertar(n->ranura, plazo);
+			refrescarGrupo(g);
+		}
+	}
+	if(ejecutable(n)){
+		activos++;
+	}
+}
+
+template<typename T>
+void PlanificadorRR<T>::contarBaja(const Nodo* n){
+	unsigned int g = grupoDe(n);
+	grupos[g].miembros--;
+	if(disponible(n)){
+		grupos[g].activos--;
+		salirDelReparto(n);
+		if(plazoDe(n) != SIN_PLAZO){
+			grupos[g].plazos.quitar(n->ranura);
+			refrescarGrupo(g);
+		}
+	}
+	if(ejecutable(n)){
+		activos--;
+	}
+}
+
+template<typename T>
+unsigned int PlanificadorRR<T>::crearGrupo(){
+	grupos.push_back(DatosGrupo());
+	return grupos.size() - 1;
+}
+
+template<typename T>
+void PlanificadorRR<T>::pausarGrupo(unsigned int grupo){
+	assert(grupo != SIN_GRUPO && grupo < grupos.size());
+	assert(!grupos[grupo].pausado);
+	grupos[grupo].pausado = true;
+	activos -= grupos[grupo].activos;
+	refrescarGrupo(grupo);
+	refrescarReparto(grupo);
+	if(lon != 0 && grupoDe(ejec) == grupo && hayProcesosActivos()){
+		avanzarRonda();
+	}
+	informar(CAMBIO_RESINCRONIZAR);
+}
+
+template<typename T>
+void PlanificadorRR<T>::reanudarGrupo(unsigned int grupo){
+	assert(grupo != SIN_GRUPO && grupo < grupos.size());
+	assert(grupos[grupo].pausado);
+	DatosGrupo& d = grupos[grupo];
+	d.pausado = false;
+	activos += d.activos;
+	// mientras estuvo pausado los pases de los demás avanzaron
+	if(modo == REPARTO_ZANCADAS && !d.pases.vacio() && d.pases.claveMinima() + d.desfase < estadoReparto->paseGlobal){
+		d.desfase = estadoReparto->paseGlobal - d.pases.claveMinima();
+	}
+	refrescarGrupo(grupo);
+	refrescarReparto(grupo);
+	if(lon != 0 && !ejecutable(ejec) && hayProcesosActivos()){
+		avanzarRonda();
+	}
+	informar(CAMBIO_RESINCRONIZAR);
+}
+
+template<typename T>
+void PlanificadorRR<T>::refrescarGrupo(unsigned int grupo){
+	if(estadoPlazos == NULL){
+		return;
+	}
+	MonticuloIndexado& gruposConPlazo = estadoPlazos->gruposConPlazo;
+	if(gruposConPlazo.contiene(grupo)){
+		gruposConPlazo.quitar(grupo);
+	}
+	if(!grupos[grupo].pausado && !grupos[grupo].plazos.vacio()){
+		gruposConPlazo.insertar(grupo, grupos[grupo].plazos.claveMinima());
+	}
+}
+
+template<typename T>
+void PlanificadorRR<T>::asignarPlazo(const T& nom, unsigned long plazo){
+	Nodo* ite = buscar(nom);
+	assert(ite != NULL);
+	asignarPlazoANodo(ite, plazo);
+}
+
+template<typename T>
+void PlanificadorRR<T>::asignarPlazo(const Manija& m, unsigned long plazo){
+	Nodo* ite = manijas.resolver(m);
+	assert(ite != NULL);
+	asignarPlazoANodo(ite, plazo);
+}
+
+template<typename T>
+void PlanificadorRR<T>::quitarPlazo(const T& nom){
+	Nodo* ite = buscar(nom);
+	assert(ite != NULL);
+	asignarPlazoANodo(ite, SIN_PLAZO);
+}
+
+template<typename T>
+void PlanificadorRR<T>::quitarPlazo(const Manija& m){
+	Nodo* ite = manijas.resolver(m);
+	assert(ite != NULL);
+	asignarPlazoANodo(ite, SIN_PLAZO);
+}
+
+template<typename T>
+bool PlanificadorRR<T>::tienePlazo(const T& nom) const{
+	Nodo* ite = buscar(nom);
+	assert(ite != NULL);
+	return plazoDe(ite) != SIN_PLAZO;
+}
+
+template<typename T>
+void PlanificadorRR<T>::asignarPlazoANodo(Nodo* ite, unsigned long plazo){
+	unsigned long pase = paseDe(ite);
+	contarBaja(ite);
+	if(plazo != SIN_PLAZO || estadoPlazos != NULL){
+		escribirRanura(usarPlazos().plazos, ite->ranura, plazo, SIN_PLAZO);
+	}
+	contarAlta(ite);
+	fijarPase(ite, pase);
+	informar(CAMBIO_RESINCRONIZAR);
+}
+
+template<typename T>
+void PlanificadorRR<T>::repartirPorRonda(){
+	cambiarReparto(REPARTO_RONDA);
+}
+
+template<typename T>
+void PlanificadorRR<T>::repartirPorLoteria(unsigned long long semilla){
+	usarReparto().azar = GeneradorAzar(semilla, 0);
+	cambiarReparto(REPARTO_LOTERIA);
+}
+
+template<typename T>
+void PlanificadorRR<T>::repartirPorZancadas(){
+	cambiarReparto(REPARTO_ZANCADAS);
+}
+
+template<typename T>
+void PlanificadorRR<T>::limitarEjecuciones(const T& nom, unsigned int capacidad, unsigned int periodo){
+	Nodo* ite = buscar(nom);
+	assert(ite != NULL);
+	limitarEjecuciones(manijas.manija(ite->ranura), capacidad, periodo);
+}
+
+template<typename T>
+void PlanificadorRR<T>::limitarEjecuciones(const Manija& m, unsigned int capacidad, unsigned int periodo){
+	Nodo* ite = manijas.resolver(m);
+	assert(ite != NULL);
+	assert(capacidad > 0 && periodo > 0);
+	vector<Balde>& baldes = usarBaldes().baldes;
+	if(ite->ranura >= baldes.size()){
+		baldes.resize(ite->ranura + 1);
+	}
+	Balde& b = baldes[ite->ranura];
+	b.capacidad = capacidad;
+	b.periodo = periodo;
+	b.llenoEn = ahora;
+	if(ite->frenado){
+		liberar(ite);
+	}
+}
+
+template<typename T>
+void PlanificadorRR<T>::quitarLimite(const T& nom){
+	Nodo* ite = buscar(nom);
+	assert(ite != NULL);
+	Balde* b = baldeDe(ite);
+	if(b != NULL){
+		b->capacidad = 0;
+	}
+	if(ite->frenado){
+		liberar(ite);
+	}
+}
+
+template<typename T>
+bool PlanificadorRR<T>::estaFrenado(const T& nom) const{
+	Nodo* ite = buscar(nom);
+	assert(ite != NULL);
+	return ite->frenado;
+}
+
+template<typename T>
+unsigned long PlanificadorRR<T>::reloj() const{
+	return ahora;
+}
+
+template<typename T>
+void PlanificadorRR<T>::avanzarReloj(unsigned long tics){
+	ahora += tics;
+	liberarFrenados();
+}
+
+template<typename T>
+bool PlanificadorRR<T>::tieneFicha(const Nodo* n) const{
+	// llenoEn es el tic en que el balde vuelve a estar lleno: queda alguna
+	// ficha si para eso faltan menos de capacidad periodos
+	const Balde* b = baldeDe(n);
+	return b == NULL || b->capacidad == 0 || b->llenoEn <= ahora + (unsigned long)(b->capacidad - 1) * b->periodo;
+}
+
+template<typename T>
+void PlanificadorRR<T>::cobrar(Nodo* n){
+	Balde* b = baldeDe(n);
+	if(b != NULL && b->capacidad != 0){
+		b->llenoEn = max(b->llenoEn, ahora) + b->periodo;
+	}
+}
+
+template<typename T>
+unsigned long PlanificadorRR<T>::recarga(const Nodo* n) const{
+	const Balde* b = baldeDe(n);
+	return b->llenoEn - (unsigned long)(b->capacidad - 1) * b->periodo;
+}
+
+template<typename T>
+void PlanificadorRR<T>::frenar(Nodo* n){
+	// el turno que usó se paga antes de salir del reparto
+	if(modo == REPARTO_ZANCADAS && n == ejec && !hayPlazos()){
+		pagarPase(n);
+	}
+	baldeDe(n)->pase = paseDe(n);
+	contarBaja(n);
+	n->frenado = true;
+	contarAlta(n);
+	estadoBaldes->frenados.insertar(n->ranura, recarga(n));
+	informar(CAMBIO_FRENAR, n, 0);
+}
+
+template<typename T>
+void PlanificadorRR<T>::liberar(Nodo* n){
+	estadoBaldes->frenados.quitar(n->ranura);
+	contarBaja(n);
+	n->frenado = false;
+	contarAlta(n);
+	fijarPase(n, baldeDe(n)->pase);
+	if(!ejecutable(ejec) && ejecutable(n)){
+		ejec = n;
+	}
+	informar(CAMBIO_LIBERAR, n, 0);
+}
+
+template<typename T>
+void PlanificadorRR<T>::liberarFrenados(){
+	if(estadoBaldes == NULL){
+		return;
+	}
+	MonticuloIndexado& frenados = estadoBaldes->frenados;
+	while(!frenados.vacio() && frenados.claveMinima() <= ahora){
+		liberar(manijas.nodoEn(frenados.minimo()));
+	}
+}
+
+template<typename T>
+ModoDeReparto PlanificadorRR<T>::reparto() const{
+	return modo;
+}
+
+template<typename T>
+void PlanificadorRR<T>::asignarBoletos(const T& nom, unsigned int b){
+	Nodo* ite = buscar(nom);
+	assert(ite != NULL);
+	asignarBoletos(manijas.manija(ite->ranura), b);
+}
+
+template<typename T>
+void PlanificadorRR<T>::asignarBoletos(const Manija& m, unsigned int b){
+	Nodo* ite = manijas.resolver(m);
+	assert(ite != NULL);
+	assert(b > 0 && b <= ZANCADA);
+	unsigned long pase = paseDe(ite);
+	contarBaja(ite);
+	escribirRanura(usarReparto().boletos, ite->ranura, b, 1u);
+	contarAlta(ite);
+	fijarPase(ite, pase);
+	informar(CAMBIO_RESINCRONIZAR);
+}
+
+template<typename T>
+unsigned int PlanificadorRR<T>::boletos(const T& nom) const{
+	Nodo* ite = buscar(nom);
+	assert(ite != NULL);
+	return boletosDe(ite);
+}
+
+template<typename T>
+void PlanificadorRR<T>::cambiarReparto(ModoDeReparto m){
+	for(unsigned int g = 0; g < grupos.size(); g++){
+		grupos[g].boletos.vaciar();
+		grupos[g].pases.vaciar();
+		grupos[g].desfase = 0;
+	}
+	if(m != REPARTO_RONDA){
+		usarReparto();
+	}
+	if(estadoReparto != NULL){
+		estadoReparto->boletosPorGrupo.vaciar();
+		estadoReparto->gruposPorPase.vaciar();
+		estadoReparto->paseGlobal = 0;
+	}
+	if(estadoBaldes != NULL){
+		for(unsigned int r = 0; r < estadoBaldes->baldes.size(); r++){
+			estadoBaldes->baldes[r].pase = 0;
+		}
+	}
+	modo = m;
+	Nodo* ite = ejec;
+	for(unsigned int i = 0; i < lon; i++){
+		if(disponible(ite)){
+			entrarAlReparto(ite);
+		}
+		ite = ite->sig;
+	}
+	informar(CAMBIO_RESINCRONIZAR);
+}
+
+template<typename T>
+void PlanificadorRR<T>::entrarAlReparto(const Nodo* n){
+	unsigned int g = grupoDe(n);
+	if(modo == REPARTO_LOTERIA){
+		grupos[g].boletos.fijar(n->ranura, boletosDe(n));
+	}else if(modo == REPARTO_ZANCADAS){
+		grupos[g].pases.insertar(n->ranura, estadoReparto->paseGlobal - grupos[g].desfase);
+	}else{
+		return;
+	}
+	refrescarReparto(g);
+}
+
+template<typename T>
+void PlanificadorRR<T>::salirDelReparto(const Nodo* n){
+	unsigned int g = grupoDe(n);
+	if(modo == REPARTO_LOTERIA){
+		grupos[g].boletos.fijar(n->ranura, 0);
+	}else if(modo == REPARTO_ZANCADAS){
+		grupos[g].pases.quitar(n->ranura);
+	}else{
+		return;
+	}
+	refrescarReparto(g);
+}
+
+template<typename T>
+void PlanificadorRR<T>::refrescarReparto(unsigned int grupo){
+	const DatosGrupo& d = grupos[grupo];
+	if(modo == REPARTO_LOTERIA){
+		estadoReparto->boletosPorGrupo.fijar(grupo, d.pausado ? 0 : d.boletos.total());
+	}else if(modo == REPARTO_ZANCADAS){
+		MonticuloIndexado& gruposPorPase = estadoReparto->gruposPorPase;
+		if(gruposPorPase.contiene(grupo)){
+			gruposPorPase.quitar(grupo);
+		}
+		if(!d.pausado && !d.pases.vacio()){
+			gruposPorPase.insertar(grupo, d.pases.claveMinima() + d.desfase);
+		}
+	}
+}
+
+template<typename T>
+typename PlanificadorRR<T>::Nodo* PlanificadorRR<T>::sortear(){
+	EstadoReparto& e = *estadoReparto;
+	unsigned long r = e.azar.siguiente() % e.boletosPorGrupo.total();
+	unsigned int g = e.boletosPorGrupo.buscar(r);
+	return manijas.nodoEn(grupos[g].boletos.buscar(r));
+}
+
+template<typename T>
+typename PlanificadorRR<T>::Nodo* PlanificadorRR<T>::menorPase(){
+	// el que estaba ejecutándose paga el turno que usó
+	if(ejecutable(ejec)){
+		pagarPase(ejec);
+	}
+	unsigned int g = estadoReparto->gruposPorPase.minimo();
+	estadoReparto->paseGlobal = estadoReparto->gruposPorPase.claveMinima();
+	return manijas.nodoEn(grupos[g].pases.minimo());
+}
+
+template<typename T>
+unsigned long PlanificadorRR<T>::paseDe(const Nodo* n) const{
+	if(modo != REPARTO_ZANCADAS || !disponible(n)){
+		return estadoReparto == NULL ? 0 : estadoReparto->paseGlobal;
+	}
+	const DatosGrupo& d = grupos[grupoDe(n)];
+	return d.pases.clave(n->ranura) + d.desfase;
+}
+
+template<typename T>
+void PlanificadorRR<T>::fijarPase(const Nodo* n, unsigned long pase){
+	if(modo != REPARTO_ZANCADAS || !disponible(n)){
+		return;
+	}
+	unsigned int g = grupoDe(n);
+	DatosGrupo& d = grupos[g];
+	d.pases.cambiar(n->ranura, max(pase, estadoReparto->paseGlobal) - d.desfase);
+	refrescarReparto(g);
+}
+
+template<typename T>
+void PlanificadorRR<T>::pagarPase(const Nodo* n){
+	unsigned int g = grupoDe(n);
+	MonticuloIndexado& pases = grupos[g].pases;
+	pases.cambiar(n->ranura, pases.clave(n->ranura) + ZANCADA / boletosDe(n));
+	refrescarReparto(g);
+}
+
+template<typename T>
+bool PlanificadorRR<T>::grupoPausado(unsigned int grupo) const{
+	assert(grupo < grupos.size());
+	return grupos[grupo].pausado;
+}
+
+template<typename T>
+int PlanificadorRR<T>::cantidadDeProcesosDelGrupo(unsigned int grupo) const{
+	assert(grupo < grupos.size());
+	return grupos[grupo].miembros;
+}
+
+template<typename T>
+void PlanificadorRR<T>::detener(){
+	estado = false;
+	informar(CAMBIO_DETENER);
+}
+
+template<typename T>
+void PlanificadorRR<T>::reanudar(){
+	estado = true;
+	informar(CAMBIO_REANUDAR_TODO);
+	aplicarPendientes();
+}
+
+template<typename T>
+bool PlanificadorRR<T>::detenido() const{
+	if(estado == true){
+		return false;
+	}else{
+		return true;
+	}
+}
+
+template<typename T>
+void PlanificadorRR<T>::conectarCanal(CanalDeCambios<T>* c){
+	canal = c;
+	fotoPendiente = canal != NULL && lon != 0;
+	actualizarCanal();
+}
+
+template<typename T>
+bool PlanificadorRR<T>::actualizarCanal(){
+	if(canal == NULL || !fotoPendiente){
+		return true;
+	}
+	Nodo* n = ejec;
+	size_t cambios = estado ? 1 + lon : 2 + lon;
+	for(unsigned int i = 0; i < lon; i++){
+		if(!ejecutable(n)){
+			cambios++;
+		}
+		n = n->sig;
+	}
+	if(canal->lugarLibre() < cambios){
+		return false;
+	}
+	bool entro = canal->emitir(Cambio<T>(CAMBIO_FOTO, lon));
+	for(unsigned int i = 0; i < lon; i++){
+		entro = canal->emitir(Cambio<T>(CAMBIO_AGREGAR, n->nombre, grupoDe(n))) && entro;
+		n = n->sig;
+	}
+	for(unsigned int i = 0; i < lon; i++){
+		if(!ejecutable(n)){
+			TipoDeCambio t = n->frenado && n->activo && !grupos[grupoDe(n)].pausado ? CAMBIO_FRENAR : CAMBIO_PAUSAR;
+			entro = canal->emitir(Cambio<T>(t, n->nombre, 0)) && entro;
 		}
-	nuevo = ejec;
-	if(pcopiar->activo == false){
-		nuevo->activo = false;
-	}	
+		n = n->sig;
 	}
-	lon = i;
-	estado = proc.estado;
+	if(!estado){
+		entro = canal->emitir(Cambio<T>(CAMBIO_DETENER, 0)) && entro;
+	}
+	// sólo el productor escribe, así que el lugar que se vio sigue estando
+	assert(entro);
+	fotoPendiente = false;
+	return true;
 }
 
 template<typename T>
-PlanificadorRR<T>::~PlanificadorRR(){
-	while(ejec != NULL){
-		eliminarProceso(ejec->nombre);
+void PlanificadorRR<T>::emitir(const Cambio<T>& c, bool yaAplicado){
+	if(canal == NULL){
+		return;
+	}
+	if(fotoPendiente && (!actualizarCanal() || yaAplicado)){
+		return;
+	}
+	if(!canal->emitir(c)){
+		fotoPendiente = true;
 	}
 }
 
 template<typename T>
-void PlanificadorRR<T>::agregarProceso(const T& nom){
-	assert(esPlanificado(nom) == false);
-	Nodo* nuevo = new Nodo(nom);
-	if(lon == 0){
-		nuevo->sig = nuevo;
-		nuevo->ant = nuevo;
-		ejec = nuevo;
-	}else{
-			Nodo* ejecutado = ejec;
-			nuevo->ant = ejec->ant;
-			nuevo->sig = ejec;
-			ejecutado->ant->sig = nuevo;
-			ejecutado->ant = nuevo;
-				if(ejecutado->activo == false){
-					ejec = nuevo;
-				}
+void PlanificadorRR<T>::informar(TipoDeCambio tipo){
+	if(tipo == CAMBIO_RESINCRONIZAR){
+		if(canal != NULL){
+			fotoPendiente = true;
+			// si la foto no entra, al menos se marca dónde dejó de valer la copia
+			if(!actualizarCanal()){
+				canal->emitir(Cambio<T>(CAMBIO_RESINCRONIZAR, 0));
 			}
-	lon++;
+		}
+		desbordar();
+	}else{
+		emitir(Cambio<T>(tipo, 0), true);
+	}
 }
 
+template<typename T>
+void PlanificadorRR<T>::informar(TipoDeCambio tipo, Nodo* n, long valor){
+	// eliminar se informa antes de sacar el nodo
+	emitir(Cambio<T>(tipo, n->nombre, valor), tipo != CAMBIO_ELIMINAR);
+	if(tipo == CAMBIO_AGREGAR){
+		marcar(n, NUEVO);
+	}else if(tipo == CAMBIO_PAUSAR || tipo == CAMBIO_REANUDAR || tipo == CAMBIO_FRENAR || tipo == CAMBIO_LIBERAR){
+		marcar(n, CAMBIADO);
+	}else if(tipo == CAMBIO_ELIMINAR && siguiendo && !desbordado && n->marca != NUEVO){
+		// si se agregó después del último mostrarCambios no hay nada que sacar
+		quitados.push_back(n->nombre);
+	}
+}
 
 template<typename T>
-void PlanificadorRR<T>::eliminarProceso(const T& procAelim){
-	assert(esPlanificado(procAelim));
-	if(lon != 1){
-	Nodo* iterador = ejec;
-		while(!(iterador->nombre == procAelim)){
-			iterador = iterador->sig;
-		}
-		if(iterador->nombre == ejec->nombre){
-			ejec = iterador->sig;
+void PlanificadorRR<T>::marcar(Nodo* n, Marca m){
+	if(!siguiendo || desbordado || n->marca != LIMPIO){
+		return;
+	}
+	n->marca = m;
+	sucios.push_back(manijas.manija(n->ranura));
+	// las manijas de los eliminados también quedan en la lista
+	if(sucios.size() > 2 * (size_t)lon + 16){
+		desbordar();
+	}
+}
+
+template<typename T>
+void PlanificadorRR<T>::desbordar(){
+	if(!siguiendo){
+		return;
+	}
+	for(unsigned int i = 0; i < sucios.size(); i++){
+		Nodo* n = manijas.resolver(sucios[i]);
+		if(n != NULL){
+			n->marca = LIMPIO;
 		}
-		iterador->ant->sig = iterador->sig;
-		iterador->sig->ant = iterador->ant;
-		delete iterador;
-	}else{
-		Nodo* iterador = ejec;
-		delete iterador;
-		ejec = NULL;
 	}
-	lon--;
+	sucios.clear();
+	quitados.clear();
+	desbordado = true;
 }
 
 template<typename T>
-const T& PlanificadorRR<T>::procesoEjecutado() const{
-	assert(hayProcesosActivos() == true);
-	return ejec->nombre;
+void PlanificadorRR<T>::seguirCambios(bool s){
+	desbordar();
+	siguiendo = s;
+	desbordado = s;
+	elegidoMostrado = MANIJA_INVALIDA;
 }
 
 template<typename T>
-void PlanificadorRR<T>::ejecutarSiguienteProceso(){
-	assert(hayProcesosActivos());
-	Nodo* iterador = ejec->sig;
-	int i = lon;
-	bool c = true;
-	while(i > 1 && c){  
-		if(iterador->activo == true){
-			c = false; 
-		}else{
-		i--;
-		iterador = iterador->sig;
+bool PlanificadorRR<T>::sigueCambios() const{
+	return siguiendo;
+}
+
+template<typename T>
+ostream& PlanificadorRR<T>::mostrarCambios(ostream& os){
+	assert(siguiendo);
+	Manija actual = MANIJA_INVALIDA;
+	if(hayProcesosActivos()){
+		actual = manijas.manija(elegido()->ranura);
+	}
+	if(desbordado){
+		os << "!" << '\n';
+		desbordado = false;
+	}else{
+		for(unsigned int i = 0; i < quitados.size(); i++){
+			os << "- " << quitados[i] << '\n';
+		}
+		for(unsigned int i = 0; i < sucios.size(); i++){
+			Nodo* n = manijas.resolver(sucios[i]);
+			// se saltean los eliminados y los que ya se mostraron
+			if(n != NULL && n->marca != LIMPIO){
+				os << (n->marca == NUEVO ? "+ " : "~ ");
+				mostrarProceso(os, n);
+				os << '\n';
+				n->marca = LIMPIO;
+			}
+		}
+		if(actual != elegidoMostrado){
+			if(actual == MANIJA_INVALIDA){
+				os << "* -" << '\n';
+			}else{
+				os << "* " << elegido()->nombre << '\n';
+			}
 		}
 	}
-	ejec = iterador;
+	sucios.clear();
+	quitados.clear();
+	elegidoMostrado = actual;
+	return os;
 }
 
 template<typename T>
-void PlanificadorRR<T>::pausarProceso(const T& nom){
-	assert(esPlanificado(nom));
-	Nodo* ite = ejec;
-	while(!(ite->nombre == nom)){ //cambiar por not
-		ite = ite->sig;
+Manija PlanificadorRR<T>::mostrarPagina(ostream& os, const Manija& desde, unsigned int cantidad) const{
+	assert(cantidad > 0);
+	Manija siguiente = MANIJA_INVALIDA;
+	os << "[";
+	if(lon != 0){
+		Nodo* inicio = elegido();
+		Nodo* ite = inicio;
+		if(desde != MANIJA_INVALIDA){
+			ite = manijas.resolver(desde);
+			assert(ite != NULL);
+		}
+		unsigned int i = 0;
+		do{
+			if(i != 0){
+				os << ", ";
+			}
+			mostrarProceso(os, ite);
+			if(ite == inicio && ejecutable(ite)){
+				os << "*";
+			}
+			ite = ite->sig;
+			i++;
+		}while(i < cantidad && ite != inicio);
+		if(ite != inicio){
+			siguiente = manijas.manija(ite->ranura);
+		}
 	}
-	ite->activo = false;
-	if(ejec == ite){
-		if(hayProcesosActivos()){
-			ejecutarSiguienteProceso();
+	os << "]";
+	return siguiente;
+}
+
+template<typename T>
+void PlanificadorRR<T>::mostrarProceso(ostream& os, const Nodo* n) const{
+	os << n->nombre;
+	if(!ejecutable(n)){
+		// pausar tiene prioridad sobre frenar
+		if(n->frenado && n->activo && !grupos[grupoDe(n)].pausado){
+			os << " (f)";
+		}else{
+			os << " (i)";
 		}
 	}
 }
 
 template<typename T>
-void PlanificadorRR<T>::reanudarProceso(const T& nom){
-	assert(esPlanificado(nom));
-	Nodo* ite = ejec;
-	while(!(ite->nombre == nom)){
-		ite = ite->sig;
+void PlanificadorRR<T>::diferirCambios(bool d){
+	diferir = d;
+	if(diferir){
+		usarDiferido();
+	}else{
+		aplicarPendientes();
 	}
-	ite->activo = true;
-	if(ejec->activo == false){
-		ejec = ite;
+}
+
+template<typename T>
+bool PlanificadorRR<T>::difiereCambios() const{
+	return diferir;
+}
+
+template<typename T>
+int PlanificadorRR<T>::cantidadDeCambiosPendientes() const{
+	return estadoDiferido == NULL ? 0 : estadoDiferido->vivos;
+}
+
+template<typename T>
+void PlanificadorRR<T>::diferirBorrado(bool d){
+	borradoDiferido = d;
+	if(!borradoDiferido){
+		compactando = NULL;
 	}
+}
 
+template<typename T>
+bool PlanificadorRR<T>::difiereBorrado() const{
+	return borradoDiferido;
 }
 
+template<typename T>
+int PlanificadorRR<T>::cantidadDeLapidas() const{
+	return arena.lapidas();
+}
 
 template<typename T>
-void PlanificadorRR<T>::detener(){
-	estado = false;
+bool PlanificadorRR<T>::estaCompactando() const{
+	return compactando != NULL;
 }
 
 template<typename T>
-void PlanificadorRR<T>::reanudar(){
-	estado = true;
+void PlanificadorRR<T>::anotarAgregado(const T& nom, unsigned int grupo){
+	EstadoDiferido& d = *estadoDiferido;
+	d.agregados.push_back(d.pendientes.size());
+	d.pendientes.push_back(Pendiente(Pendiente::AGREGAR, nom, grupo, MANIJA_INVALIDA));
+	d.vivos++;
 }
 
 template<typename T>
-bool PlanificadorRR<T>::detenido() const{
-	if(estado == true){
-		return false;
+void PlanificadorRR<T>::anotar(typename Pendiente::Tipo tipo, const T& nom){
+	const EstadoDiferido& d = *estadoDiferido;
+	for(unsigned int k = d.agregados.size(); k > 0; k--){
+		const Pendiente& p = d.pendientes[d.agregados[k - 1]];
+		if(p.tipo == Pendiente::AGREGAR && p.nombre == nom){
+			compactarPendiente(d.agregados[k - 1], tipo);
+			return;
+		}
+	}
+	Nodo* n = buscar(nom);
+	assert(n != NULL);
+	anotar(tipo, n);
+}
+
+template<typename T>
+void PlanificadorRR<T>::anotar(typename Pendiente::Tipo tipo, Nodo* n){
+	EstadoDiferido& d = *estadoDiferido;
+	unsigned int i = pendienteDe(n);
+	if(i != SIN_PENDIENTE){
+		compactarPendiente(i, tipo);
+		return;
+	}
+	escribirRanura(d.pendientePorRanura, n->ranura, (unsigned int)d.pendientes.size(), SIN_PENDIENTE);
+	d.pendientes.push_back(Pendiente(tipo, n->nombre, SIN_GRUPO, manijas.manija(n->ranura)));
+	d.vivos++;
+}
+
+template<typename T>
+void PlanificadorRR<T>::compactarPendiente(unsigned int i, typename Pendiente::Tipo tipo){
+	Pendiente& previo = estadoDiferido->pendientes[i];
+	// se agregó o se eliminó en esta misma interrupción
+	assert(previo.tipo != Pendiente::ELIMINAR && tipo != Pendiente::AGREGAR);
+	if(tipo == Pendiente::ELIMINAR){
+		// eliminar un proceso agregado en esta interrupción lo cancela; si no,
+		// lo que se le había hecho deja de importar
+		if(previo.tipo == Pendiente::AGREGAR){
+			cancelarPendiente(i);
+		}else{
+			previo.tipo = Pendiente::ELIMINAR;
+		}
+	}else if(previo.tipo == Pendiente::AGREGAR){
+		previo.activo = (tipo == Pendiente::REANUDAR);
 	}else{
-		return true;
+		// por las precondiciones, pausar y reanudar se alternan y se cancelan
+		assert(previo.tipo != tipo);
+		cancelarPendiente(i);
+	}
+}
+
+template<typename T>
+void PlanificadorRR<T>::cancelarPendiente(unsigned int i){
+	EstadoDiferido& d = *estadoDiferido;
+	vector<Pendiente>& pendientes = d.pendientes;
+	Pendiente& p = pendientes[i];
+	if(p.tipo != Pendiente::AGREGAR){
+		d.pendientePorRanura[p.manija.ranura] = SIN_PENDIENTE;
+	}
+	p.tipo = Pendiente::NADA;
+	d.vivos--;
+	if(pendientes.size() <= 2 * d.vivos + 16){
+		return;
+	}
+	// se sacan los cancelados y se rehacen los índices
+	unsigned int quedan = 0;
+	d.agregados.clear();
+	for(unsigned int j = 0; j < pendientes.size(); j++){
+		if(pendientes[j].tipo == Pendiente::NADA){
+			continue;
+		}
+		if(quedan != j){
+			// T no tiene operator=: se reconstruye en su lugar
+			pendientes[quedan].~Pendiente();
+			new (&pendientes[quedan]) Pendiente(pendientes[j]);
+		}
+		if(pendientes[quedan].tipo == Pendiente::AGREGAR){
+			d.agregados.push_back(quedan);
+		}else{
+			d.pendientePorRanura[pendientes[quedan].manija.ranura] = quedan;
+		}
+		quedan++;
+	}
+	while(pendientes.size() > quedan){
+		pendientes.pop_back();
+	}
+}
+
+template<typename T>
+void PlanificadorRR<T>::aplicarPendientes(){
+	if(estadoDiferido == NULL){
+		return;
+	}
+	EstadoDiferido& d = *estadoDiferido;
+	vector<Pendiente> lote;
+	lote.swap(d.pendientes);
+	d.agregados.clear();
+	d.vivos = 0;
+	for(unsigned int i = 0; i < lote.size(); i++){
+		const Pendiente& p = lote[i];
+		if(p.tipo == Pendiente::AGREGAR){
+			Manija m = agregarProceso(p.nombre, p.grupo);
+			if(!p.activo){
+				pausarNodo(manijas.resolver(m));
+			}
+		}else if(p.tipo != Pendiente::NADA){
+			d.pendientePorRanura[p.manija.ranura] = SIN_PENDIENTE;
+			if(p.tipo == Pendiente::ELIMINAR){
+				eliminarProceso(p.manija);
+			}else if(p.tipo == Pendiente::PAUSAR){
+				pausarProceso(p.manija);
+			}else{
+				reanudarProceso(p.manija);
+			}
+		}
 	}
 }
 
@@ -366,18 +2623,65 @@ bool PlanificadorRR<T>::esPlanificado(const T& proc) const{
 
 template<typename T>
 bool PlanificadorRR<T>::estaActivo(const T& proc) const{
-	assert(proc.esPlanificado());
-	Nodo* proceso = ejec;
-	int i = lon;
-	bool s = true;
-	while(i > 0 && s){ //chequear este while, por ahí i tiene que ser >= 0
-		if(proceso->nombre == proc){
-			s = false;
+	Nodo* proceso = buscar(proc);
+	assert(proceso != NULL);
+	return ejecutable(proceso);
+}
+
+template<typename T>
+template<typename K>
+typename SiEsClave<T, K, bool>::type PlanificadorRR<T>::esPlanificado(const K& clave) const{
+	return buscar(clave) != NULL;
+}
+
+template<typename T>
+template<typename K>
+typename SiEsClave<T, K, bool>::type PlanificadorRR<T>::estaActivo(const K& clave) const{
+	Nodo* proceso = buscar(clave);
+	assert(proceso != NULL);
+	return ejecutable(proceso);
+}
+
+template<typename T>
+template<typename K>
+typename SiEsClave<T, K, bool>::type PlanificadorRR<T>::tienePlazo(const K& clave) const{
+	Nodo* ite = buscar(clave);
+	assert(ite != NULL);
+	return plazoDe(ite) != SIN_PLAZO;
+}
+
+template<typename T>
+bool PlanificadorRR<T>::estaActivo(const Manija& m) const{
+	Nodo* proceso = manijas.resolver(m);
+	assert(proceso != NULL);
+	return ejecutable(proceso);
+}
+
+template<typename T>
+bool PlanificadorRR<T>::esValida(const Manija& m) const{
+	return manijas.resolver(m) != NULL;
+}
+
+template<typename T>
+const T& PlanificadorRR<T>::proceso(const Manija& m) const{
+	Nodo* proceso = manijas.resolver(m);
+	assert(proceso != NULL);
+	return proceso->nombre;
+}
+
+template<typename T>
+template<typename K>
+typename PlanificadorRR<T>::Nodo* PlanificadorRR<T>::buscar(const K& proc) const{
+	Nodo* iterador = ejec;
+	unsigned int i = lon;
+	while(i > 0){
+		if(iterador->nombre == proc){
+			return iterador;
 		}
-	i--;
-	proceso = proceso->sig;
+		iterador = iterador->sig;
+		i--;
 	}
-	return proceso->activo;
+	return NULL;
 }
 
 template<typename T>
@@ -390,61 +2694,29 @@ bool PlanificadorRR<T>::hayProcesos() const{  //compiló
 }
 
 template<typename T>
-bool PlanificadorRR<T>::hayProcesosActivos() const{ //me la estoy complicando demasiado?
-	bool c = false;
-	if(lon == 0){
-		return false;
-	}else{
-		Nodo* iterador = ejec;
-		if(iterador->activo == true){
-			return true;
-		}else{
-			iterador = iterador->sig;
-			while(iterador != ejec && !c){
-				c = iterador->activo;
-				iterador = iterador->sig;
-			}
-		}
-	}
-	return c;
-} //compiló
+bool PlanificadorRR<T>::hayProcesosActivos() const{
+	return activos != 0;
+}
 
 template<typename T>
-int PlanificadorRR<T>::cantidadDeProcesosActivos() const{ //compiló
-	if(lon == 0){
- 		return 0;
- 	}
- 	Nodo* iterador = ejec;
-	int i = 0;
-		while(iterador->sig != ejec){
-			if(iterador->activo == true){
-				i++;
-			}
-			iterador = iterador->sig;
-		}
-		if(iterador->activo == true){
-			i++;
-		}
-	return i;
+int PlanificadorRR<T>::cantidadDeProcesosActivos() const{
+	return activos;
 }
 
 template<typename T>
 ostream& PlanificadorRR<T>::mostrarPlanificadorRR(ostream& os) const{
 	os << "[";
 	if(lon != 0){
-		Nodo* ite = ejec;
-		if(ite->activo == false){
-			os << ite->nombre << " (i)";
-		}else{
-		os << ite->nombre << "*";
+		Nodo* inicio = elegido();
+		Nodo* ite = inicio;
+		mostrarProceso(os, ite);
+		if(ejecutable(ite)){
+			os << "*";
 		}
 		ite = ite->sig;
-		while(ite != ejec){
-			if(ite->activo == false){
-				os << ", " << ite->nombre << " (i)";
-			}else{
-				os << ", " << ite->nombre;
-			}
+		while(ite != inicio){
+			os << ", ";
+			mostrarProceso(os, ite);
 			ite = ite->sig;
 		}
 	os << "]";
@@ -454,6 +2726,31 @@ ostream& PlanificadorRR<T>::mostrarPlanificadorRR(ostream& os) const{
 	return os;
 }
 
+template<typename T>
+size_t PlanificadorRR<T>::memoriaUtilizada() const{
+	size_t res = sizeof(*this) + lon * sizeof(Nodo) + manijas.memoriaUtilizada() + grupos.capacity() * sizeof(DatosGrupo)
+		+ grupoPorRanura.capacity() * sizeof(unsigned int) + arena.memoriaOciosa()
+		+ sucios.capacity() * sizeof(Manija) + quitados.capacity() * sizeof(T);
+	for(unsigned int g = 0; g < grupos.size(); g++){
+		res += grupos[g].plazos.memoriaUtilizada() + grupos[g].boletos.memoriaUtilizada() + grupos[g].pases.memoriaUtilizada();
+	}
+	if(estadoPlazos != NULL){
+		res += sizeof(EstadoPlazos) + estadoPlazos->plazos.capacity() * sizeof(unsigned long) + estadoPlazos->gruposConPlazo.memoriaUtilizada();
+	}
+	if(estadoReparto != NULL){
+		res += sizeof(EstadoReparto) + estadoReparto->boletos.capacity() * sizeof(unsigned int)
+			+ estadoReparto->boletosPorGrupo.memoriaUtilizada() + estadoReparto->gruposPorPase.memoriaUtilizada();
+	}
+	if(estadoBaldes != NULL){
+		res += sizeof(EstadoBaldes) + estadoBaldes->baldes.capacity() * sizeof(Balde) + estadoBaldes->frenados.memoriaUtilizada();
+	}
+	if(estadoDiferido != NULL){
+		res += sizeof(EstadoDiferido) + estadoDiferido->pendientePorRanura.capacity() * sizeof(unsigned int)
+			+ estadoDiferido->pendientes.capacity() * sizeof(Pendiente) + estadoDiferido->agregados.capacity() * sizeof(unsigned int);
+	}
+	return res;
+}
+
 template<typename T>
 bool PlanificadorRR<T>::operator==(const PlanificadorRR<T>& copia) const{
 	bool b = true;
@@ -464,7 +2761,7 @@ bool PlanificadorRR<T>::operator==(const PlanificadorRR<T>& copia) const{
 		Nodo* izq = ejec;
 		Nodo* der = copia.ejec;
 		while(i > 0 && b){
-		if((izq->activo != der->activo) || !(izq->nombre == der->nombre)){
+		if((ejecutable(izq) != copia.ejecutable(der)) || !(izq->nombre == der->nombre)){
 			b = false;
 		}
 			i--;
@@ -475,6 +2772,188 @@ bool PlanificadorRR<T>::operator==(const PlanificadorRR<T>& copia) const{
 	return b;
 }
 
+template<typename T>
+typename PlanificadorRR<T>::const_iterator PlanificadorRR<T>::begin() const{
+	return const_iterator(this, elegido(), 0, false);
+}
+
+template<typename T>
+typename PlanificadorRR<T>::const_iterator PlanificadorRR<T>::end() const{
+	return const_iterator(this, elegido(), lon, false);
+}
+
+template<typename T>
+typename PlanificadorRR<T>::Vista PlanificadorRR<T>::vistaDesdeEjecutado() const{
+	return Vista(begin(), end());
+}
+
+template<typename T>
+typename PlanificadorRR<T>::Vista PlanificadorRR<T>::vistaActivos() const{
+	Nodo* primero = elegido();
+	const_iterator inicio(this, primero, 0, true);
+	if(lon != 0 && !ejecutable(primero)){
+		++inicio;
+	}
+	return Vista(inicio, const_iterator(this, primero, lon, true));
+}
+
+template<typename T>
+void PlanificadorRR<T>::transferirProcesos(PlanificadorRR<T>& origen, const T& primero, unsigned int cantidad){
+	Nodo* nodo = origen.buscar(primero);
+	assert(nodo != NULL);
+	origen.cortarArco(nodo, cantidad);
+	adoptarCadena(origen, nodo, cantidad);
+}
+
+template<typename T>
+void PlanificadorRR<T>::transferirProcesos(PlanificadorRR<T>& origen, const Manija& primero, unsigned int cantidad){
+	Nodo* nodo = origen.manijas.resolver(primero);
+	assert(nodo != NULL);
+	origen.cortarArco(nodo, cantidad);
+	adoptarCadena(origen, nodo, cantidad);
+}
+
+template<typename T>
+void PlanificadorRR<T>::unir(PlanificadorRR<T>& otro){
+	if(otro.lon != 0){
+		unsigned int cantidad = otro.lon;
+		Nodo* primero = otro.ejec;
+		otro.cortarArco(primero, cantidad);
+		adoptarCadena(otro, primero, cantidad);
+	}
+}
+
+template<typename T>
+template<typename Predicado>
+void PlanificadorRR<T>::separar(PlanificadorRR<T>& destino, Predicado cumple){
+	assert(&destino != this);
+	Nodo* primero = NULL;
+	Nodo* ultimo = NULL;
+	unsigned int cantidad = 0;
+	Nodo* ite = ejec;
+	unsigned int i = lon;
+	while(i > 0){
+		Nodo* sig = ite->sig;
+		if(cumple(ite->nombre)){
+			desenlazar(ite);
+			if(primero == NULL){
+				primero = ite;
+			}else{
+				ultimo->sig = ite;
+				ite->ant = ultimo;
+			}
+			ultimo = ite;
+			cantidad++;
+		}
+		ite = sig;
+		i--;
+	}
+	if(cantidad != 0){
+		informar(CAMBIO_RESINCRONIZAR);
+		destino.adoptarCadena(*this, primero, cantidad);
+	}
+}
+
+template<typename T>
+void PlanificadorRR<T>::cortarArco(Nodo* primero, unsigned int cantidad){
+	assert(cantidad > 0 && cantidad <= lon);
+	bool conEjecutado = false;
+	bool conCompactando = false;
+	Nodo* ultimo = primero;
+	for(unsigned int i = 1; i <= cantidad; i++){
+		conEjecutado = conEjecutado || ultimo == ejec;
+		conCompactando = conCompactando || ultimo == compactando;
+		contarBaja(ultimo);
+		// los frenados se van sueltos: el reloj es de cada planificador
+		if(ultimo->frenado){
+			estadoBaldes->frenados.quitar(ultimo->ranura);
+			ultimo->frenado = false;
+		}
+		if(i < cantidad){
+			ultimo = ultimo->sig;
+		}
+	}
+	if(cantidad == lon){
+		ejec = NULL;
+		compactando = NULL;
+	}else{
+		Nodo* antes = primero->ant;
+		Nodo* despues = ultimo->sig;
+		antes->sig = despues;
+		despues->ant = antes;
+		if(conEjecutado){
+			ejec = despues;
+		}
+		if(conCompactando){
+			compactando = despues;
+		}
+	}
+	lon -= cantidad;
+	// si el que sigue está pausado, pasa a ejecutarse el siguiente activo
+	if(conEjecutado && ejec != NULL && !ejecutable(ejec) && hayProcesosActivos()){
+		avanzarRonda();
+	}
+	informar(CAMBIO_RESINCRONIZAR);
+}
+
+template<typename T>
+void PlanificadorRR<T>::adoptarCadena(PlanificadorRR<T>& origen, Nodo* primero, unsigned int cantidad){
+	assert(&origen != this);
+	Nodo* primerActivo = NULL;
+	Nodo* ultimo = NULL;
+	Nodo* ite = primero;
+	for(unsigned int i = 0; i < cantidad; i++){
+		Nodo* sig = ite->sig;
+		// su cambio pendiente no se puede aplicar en origen
+		if(origen.pendienteDe(ite) != SIN_PENDIENTE){
+			origen.cancelarPendiente(origen.pendienteDe(ite));
+		}
+		EstadoProceso e = origen.estadoDe(ite);
+		origen.manijas.liberar(ite->ranura);
+		Nodo* movido = ite;
+		if(origen.arena.esPropio(ite)){
+			// la arena de origen no puede prestar sus nodos
+			movido = nuevoNodo(ite->nombre);
+			origen.liberarNodo(ite);
+		}
+		registrarNodo(movido);
+		// los grupos son de cada planificador
+		e.grupo = SIN_GRUPO;
+		// lo que se anotó para mostrarCambios queda en origen
+		e.marca = LIMPIO;
+		// el balde llega lleno
+		e.balde.llenoEn = ahora;
+		copiarEstado(movido, e);
+		contarAlta(movido);
+		if(primerActivo == NULL && movido->activo){
+			primerActivo = movido;
+		}
+		if(ultimo == NULL){
+			primero = movido;
+		}else{
+			ultimo->sig = movido;
+			movido->ant = ultimo;
+		}
+		ultimo = movido;
+		ite = sig;
+	}
+	if(lon == 0){
+		primero->ant = ultimo;
+		ultimo->sig = primero;
+		ejec = primero;
+	}else{
+		primero->ant = ejec->ant;
+		ultimo->sig = ejec;
+		ejec->ant->sig = primero;
+		ejec->ant = ultimo;
+	}
+	lon += cantidad;
+	if(!ejecutable(ejec) && primerActivo != NULL){
+		ejec = primerActivo;
+	}
+	informar(CAMBIO_RESINCRONIZAR);
+}
+
 template<class T>
 ostream& operator<<(ostream& out, const PlanificadorRR<T>& a) {
 	return a.mostrarPlanificadorRR(out);
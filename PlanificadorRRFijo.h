@@ -0,0 +1,372 @@
+#ifndef PLANIFICADOR_RR_FIJO_H_
+#define PLANIFICADOR_RR_FIJO_H_
+
+#include <iostream>
+#include <cassert>
+#include <new>
+using namespace std;
+
+/**
+ * Planificador Round Robin con lugar para N procesos fijado al compilar. Los
+ * procesos viven en un arreglo dentro del objeto y el anillo se enlaza por
+ * índices, así que ninguna operación pide ni devuelve memoria al heap y el
+ * peor caso de cada una no depende del asignador. Se comporta y se muestra
+ * igual que PlanificadorRR (sin grupos, plazos, manijas ni modo diferido).
+ *
+ * Se puede asumir que el tipo T tiene constructor por copia y operator==
+ * No se puede asumir que el tipo T tenga operator=
+ */
+template<typename T, unsigned int N>
+class PlanificadorRRFijo {
+
+	static_assert(N > 0, "el planificador tiene que tener lugar para algún proceso");
+
+  public:
+
+	/**
+	 * Cantidad máxima de procesos.
+	 */
+	static constexpr unsigned int capacidad() { return N; }
+
+	PlanificadorRRFijo();
+
+	PlanificadorRRFijo(const PlanificadorRRFijo<T, N>&);
+
+	~PlanificadorRRFijo();
+
+	/**
+	 * Agrega un proceso como PlanificadorRR::agregarProceso. Si el
+	 * planificador está lleno no lo agrega y devuelve false.
+	 * PRE: El proceso no está siendo planificado por el planificador.
+	 */
+	bool agregarProceso(const T&);
+
+	/**
+	 * PRE: El proceso está siendo planificado por el planificador.
+	 */
+	void eliminarProceso(const T&);
+
+	/**
+	 * PRE: Hay al menos un proceso activo en el planificador.
+	 */
+	const T& procesoEjecutado() const;
+
+	/**
+	 * PRE: Hay al menos un proceso activo en el planificador.
+	 */
+	void ejecutarSiguienteProceso();
+
+	/**
+	 * PRE: El proceso está siendo planificado por el planificador.
+	 */
+	void pausarProceso(const T&);
+	void reanudarProceso(const T&);
+
+	void detener();
+	void reanudar();
+	bool detenido() const;
+
+	bool esPlanificado(const T&) const;
+
+	/**
+	 * PRE: El proceso está siendo planificado por el planificador.
+	 */
+	bool estaActivo(const T&) const;
+
+	bool hayProcesosActivos() const;
+	int cantidadDeProcesos() const;
+	int cantidadDeProcesosActivos() const;
+
+	/**
+	 * Informa si no queda lugar para otro proceso.
+	 */
+	bool estaLleno() const;
+
+	bool operator==(const PlanificadorRRFijo<T, N>&) const;
+
+	/**
+	 * Muestra los procesos con el mismo formato que PlanificadorRR.
+	 */
+	ostream& mostrarPlanificadorRR(ostream&) const;
+
+  private:
+
+	PlanificadorRRFijo<T, N>& operator=(const PlanificadorRRFijo<T, N>&);
+
+	/**
+	 * Índice que no es de ningún proceso.
+	 */
+	static const unsigned int NINGUNO = N;
+
+	T& nombre(unsigned int i) { return *reinterpret_cast<T*>(datos + i * sizeof(T)); }
+	const T& nombre(unsigned int i) const { return *reinterpret_cast<const T*>(datos + i * sizeof(T)); }
+
+	/**
+	 * Devuelve el índice del proceso, o NINGUNO si no está planificado.
+	 */
+	unsigned int buscar(const T&) const;
+
+	/**
+	 * Pasa la ejecución al siguiente proceso activo.
+	 * PRE: Hay al menos un proceso activo en el planificador.
+	 */
+	void avanzarRonda();
+
+	alignas(T) unsigned char datos[N * sizeof(T)];
+	unsigned int sig[N];
+	unsigned int ant[N];
+	bool activo[N];
+	// pila de índices sin proceso
+	unsigned int libres[N];
+	unsigned int cantidadLibres;
+	unsigned int lon;
+	unsigned int ejec;
+	unsigned int activos;
+	bool estado;
+};
+
+
+template<typename T, unsigned int N>
+PlanificadorRRFijo<T, N>::PlanificadorRRFijo(): cantidadLibres(N), lon(0), ejec(NINGUNO), activos(0), estado(true){
+	for(unsigned int i = 0; i < N; i++){
+		libres[i] = N - 1 - i;
+	}
+}
+
+template<typename T, unsigned int N>
+PlanificadorRRFijo<T, N>::PlanificadorRRFijo(const PlanificadorRRFijo<T, N>& otro): cantidadLibres(N), lon(0), ejec(NINGUNO), activos(0), estado(otro.estado){
+	for(unsigned int i = 0; i < N; i++){
+		libres[i] = N - 1 - i;
+	}
+	// se copia en orden a partir del ejecutado, que queda en el índice 0
+	unsigned int j = otro.ejec;
+	for(unsigned int i = 0; i < otro.lon; i++){
+		new (datos + i * sizeof(T)) T(otro.nombre(j));
+		activo[i] = otro.activo[j];
+		sig[i] = (i + 1) % otro.lon;
+		ant[i] = (i + otro.lon - 1) % otro.lon;
+		j = otro.sig[j];
+	}
+	if(otro.lon != 0){
+		ejec = 0;
+	}
+	lon = otro.lon;
+	activos = otro.activos;
+	// quedan libres los índices del lon en adelante
+	cantidadLibres = N - lon;
+}
+
+template<typename T, unsigned int N>
+PlanificadorRRFijo<T, N>::~PlanificadorRRFijo(){
+	unsigned int i = ejec;
+	for(unsigned int k = 0; k < lon; k++){
+		nombre(i).~T();
+		i = sig[i];
+	}
+}
+
+template<typename T, unsigned int N>
+bool PlanificadorRRFijo<T, N>::agregarProceso(const T& nom){
+	assert(!esPlanificado(nom));
+	if(cantidadLibres == 0){
+		return false;
+	}
+	cantidadLibres--;
+	unsigned int nuevo = libres[cantidadLibres];
+	new (datos + nuevo * sizeof(T)) T(nom);
+	activo[nuevo] = true;
+	activos++;
+	if(lon == 0){
+		sig[nuevo] = nuevo;
+		ant[nuevo] = nuevo;
+		ejec = nuevo;
+	}else{
+		sig[nuevo] = ejec;
+		ant[nuevo] = ant[ejec];
+		sig[ant[ejec]] = nuevo;
+		ant[ejec] = nuevo;
+		if(!activo[ejec]){
+			ejec = nuevo;
+		}
+	}
+	lon++;
+	return true;
+}
+
+template<typename T, unsigned int N>
+void PlanificadorRRFijo<T, N>::eliminarProceso(const T& nom){
+	unsigned int i = buscar(nom);
+	assert(i != NINGUNO);
+	if(activo[i]){
+		activos--;
+	}
+	bool eraEjecutado = false;
+	if(lon != 1){
+		eraEjecutado = (i == ejec);
+		if(eraEjecutado){
+			ejec = sig[i];
+		}
+		sig[ant[i]] = sig[i];
+		ant[sig[i]] = ant[i];
+	}else{
+		ejec = NINGUNO;
+	}
+	lon--;
+	nombre(i).~T();
+	libres[cantidadLibres] = i;
+	cantidadLibres++;
+	// si el que sigue está pausado, pasa a ejecutarse el siguiente activo
+	if(eraEjecutado && !activo[ejec] && hayProcesosActivos()){
+		avanzarRonda();
+	}
+}
+
+template<typename T, unsigned int N>
+const T& PlanificadorRRFijo<T, N>::procesoEjecutado() const{
+	assert(hayProcesosActivos());
+	return nombre(ejec);
+}
+
+template<typename T, unsigned int N>
+void PlanificadorRRFijo<T, N>::ejecutarSiguienteProceso(){
+	avanzarRonda();
+}
+
+template<typename T, unsigned int N>
+void PlanificadorRRFijo<T, N>::avanzarRonda(){
+	assert(hayProcesosActivos());
+	unsigned int i = sig[ejec];
+	for(unsigned int k = lon; k > 1 && !activo[i]; k--){
+		i = sig[i];
+	}
+	ejec = i;
+}
+
+template<typename T, unsigned int N>
+void PlanificadorRRFijo<T, N>::pausarProceso(const T& nom){
+	unsigned int i = buscar(nom);
+	assert(i != NINGUNO);
+	if(activo[i]){
+		activos--;
+	}
+	activo[i] = false;
+	if(i == ejec && hayProcesosActivos()){
+		avanzarRonda();
+	}
+}
+
+template<typename T, unsigned int N>
+void PlanificadorRRFijo<T, N>::reanudarProceso(const T& nom){
+	unsigned int i = buscar(nom);
+	assert(i != NINGUNO);
+	if(!activo[i]){
+		activos++;
+	}
+	activo[i] = true;
+	if(!activo[ejec]){
+		ejec = i;
+	}
+}
+
+template<typename T, unsigned int N>
+void PlanificadorRRFijo<T, N>::detener(){
+	estado = false;
+}
+
+template<typename T, unsigned int N>
+void PlanificadorRRFijo<T, N>::reanudar(){
+	estado = true;
+}
+
+template<typename T, unsigned int N>
+bool PlanificadorRRFijo<T, N>::detenido() const{
+	return !estado;
+}
+
+template<typename T, unsigned int N>
+bool PlanificadorRRFijo<T, N>::esPlanificado(const T& nom) const{
+	return buscar(nom) != NINGUNO;
+}
+
+template<typename T, unsigned int N>
+bool PlanificadorRRFijo<T, N>::estaActivo(const T& nom) const{
+	unsigned int i = buscar(nom);
+	assert(i != NINGUNO);
+	return activo[i];
+}
+
+template<typename T, unsigned int N>
+bool PlanificadorRRFijo<T, N>::hayProcesosActivos() const{
+	return activos > 0;
+}
+
+template<typename T, unsigned int N>
+int PlanificadorRRFijo<T, N>::cantidadDeProcesos() const{
+	return lon;
+}
+
+template<typename T, unsigned int N>
+int PlanificadorRRFijo<T, N>::cantidadDeProcesosActivos() const{
+	return activos;
+}
+
+template<typename T, unsigned int N>
+bool PlanificadorRRFijo<T, N>::estaLleno() const{
+	return cantidadLibres == 0;
+}
+
+template<typename T, unsigned int N>
+unsigned int PlanificadorRRFijo<T, N>::buscar(const T& nom) const{
+	unsigned int i = ejec;
+	for(unsigned int k = 0; k < lon; k++){
+		if(nombre(i) == nom){
+			return i;
+		}
+		i = sig[i];
+	}
+	return NINGUNO;
+}
+
+template<typename T, unsigned int N>
+bool PlanificadorRRFijo<T, N>::operator==(const PlanificadorRRFijo<T, N>& otro) const{
+	if(lon != otro.lon || estado != otro.estado){
+		return false;
+	}
+	unsigned int i = ejec;
+	unsigned int j = otro.ejec;
+	for(unsigned int k = 0; k < lon; k++){
+		if(activo[i] != otro.activo[j] || !(nombre(i) == otro.nombre(j))){
+			return false;
+		}
+		i = sig[i];
+		j = otro.sig[j];
+	}
+	return true;
+}
+
+template<typename T, unsigned int N>
+ostream& PlanificadorRRFijo<T, N>::mostrarPlanificadorRR(ostream& os) const{
+	os << "[";
+	unsigned int i = ejec;
+	for(unsigned int k = 0; k < lon; k++){
+		if(k != 0){
+			os << ", ";
+		}
+		os << nombre(i);
+		if(!activo[i]){
+			os << " (i)";
+		}else if(k == 0){
+			os << "*";
+		}
+		i = sig[i];
+	}
+	os << "]";
+	return os;
+}
+
+template<typename T, unsigned int N>
+ostream& operator<<(ostream& out, const PlanificadorRRFijo<T, N>& a) {
+	return a.mostrarPlanificadorRR(out);
+}
+
+#endif // PLANIFICADOR_RR_FIJO_H_
@@ -0,0 +1,168 @@
+#ifndef SIMULADOR_TORNEOS_H_
+#define SIMULADOR_TORNEOS_H_
+
+#include <cassert>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "azar.h"
+#include "cartas_enlazadas.h"
+using namespace std;
+
+/**
+ * Reglas de las partidas simuladas. En cada ronda se adelanta el mazo rojo y
+ * el mazo azul entre 1 y la cantidad de jugadores posiciones, y el jugador
+ * con el mazo rojo suma entre 1 y puntosMaximos puntos. Cada eliminarCada
+ * rondas (si no es 0) se elimina al jugador con el mazo azul, mientras queden
+ * más de dos. Al final gana el que más puntos tiene; si hay empate en el
+ * primer puesto la partida no tiene ganador.
+ */
+struct ReglasTorneo {
+	unsigned int jugadores;
+	unsigned int rondas;
+	unsigned int eliminarCada;
+	int puntosMaximos;
+
+	ReglasTorneo() : jugadores(4), rondas(20), eliminarCada(0), puntosMaximos(6) {}
+};
+
+/**
+ * Resultado de una simulación: cuántas partidas ganó cada jugador (los
+ * jugadores se numeran desde 0 en el orden en que se sientan), cuántas
+ * terminaron empatadas y cuánto tardó.
+ */
+struct ResultadoTorneo {
+	vector<unsigned long> victorias;
+	unsigned long empates;
+	unsigned long partidas;
+	double segundos;
+
+	ResultadoTorneo() : empates(0), partidas(0), segundos(0) {}
+
+	double partidasPorSegundo() const {
+		return segundos > 0 ? partidas / segundos : 0;
+	}
+
+	/**
+	 * Acumula otro resultado (con la misma cantidad de jugadores) en este.
+	 */
+	void sumar(const ResultadoTorneo& otro) {
+		if(victorias.size() < otro.victorias.size()){
+			victorias.resize(otro.victorias.size(), 0);
+		}
+		for(unsigned int i = 0; i < otro.victorias.size(); i++){
+			victorias[i] += otro.victorias[i];
+		}
+		empates += otro.empates;
+		partidas += otro.partidas;
+	}
+};
+
+/**
+ * Simula muchas partidas independientes de CartasEnlazadas repartidas entre
+ * varios hilos. La partida número i usa el flujo i de la semilla, así que el
+ * resultado depende sólo de la semilla y de la cantidad de partidas, no de la
+ * cantidad de hilos ni de cómo se intercalan. Cada hilo acumula en su propio
+ * resultado y los resultados se suman al final: los hilos no comparten nada
+ * mientras simulan.
+ */
+class SimuladorTorneos {
+
+  public:
+
+	/**
+	 * PRE: hilos > 0, reglas.jugadores > 0, reglas.puntosMaximos > 0
+	 */
+	SimuladorTorneos(const ReglasTorneo& reglas, unsigned int hilos);
+
+	/**
+	 * Simula la cantidad de partidas indicada y devuelve el resultado.
+	 */
+	ResultadoTorneo simular(unsigned long partidas, unsigned long long semilla) const;
+
+	/**
+	 * Juega una partida con el generador dado. Devuelve el número del
+	 * ganador, o reglas.jugadores si la partida terminó empatada.
+	 */
+	static unsigned int jugarPartida(const ReglasTorneo& reglas, GeneradorAzar& azar);
+
+  private:
+
+	/**
+	 * Juega las partidas [desde, hasta) y las acumula en resultado.
+	 */
+	void simularTramo(unsigned long desde, unsigned long hasta, unsigned long long semilla, ResultadoTorneo& resultado) const;
+
+	ReglasTorneo reglas;
+	unsigned int hilos;
+};
+
+
+inline SimuladorTorneos::SimuladorTorneos(const ReglasTorneo& r, unsigned int h) : reglas(r), hilos(h) {
+	assert(hilos > 0 && reglas.jugadores > 0 && reglas.puntosMaximos > 0);
+}
+
+inline ResultadoTorneo SimuladorTorneos::simular(unsigned long partidas, unsigned long long semilla) const{
+	std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+	unsigned int h = hilos;
+	if(partidas < h){
+		h = partidas == 0 ? 1 : partidas;
+	}
+	// cada hilo escribe sólo en su lugar del vector, que no se redimensiona
+	vector<ResultadoTorneo> parciales(h);
+	vector<thread> trabajadores;
+	for(unsigned int i = 1; i < h; i++){
+		trabajadores.push_back(thread(&SimuladorTorneos::simularTramo, this, partidas * i / h, partidas * (i + 1) / h, semilla, std::ref(parciales[i])));
+	}
+	simularTramo(0, partidas / h, semilla, parciales[0]);
+	for(unsigned int i = 0; i < trabajadores.size(); i++){
+		trabajadores[i].join();
+	}
+	ResultadoTorneo res;
+	res.victorias.resize(reglas.jugadores, 0);
+	for(unsigned int i = 0; i < h; i++){
+		res.sumar(parciales[i]);
+	}
+	res.segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+	return res;
+}
+
+inline void SimuladorTorneos::simularTramo(unsigned long desde, unsigned long hasta, unsigned long long semilla, ResultadoTorneo& resultado) const{
+	ResultadoTorneo local;
+	local.victorias.resize(reglas.jugadores, 0);
+	for(unsigned long i = desde; i < hasta; i++){
+		GeneradorAzar azar(semilla, i);
+		unsigned int ganador = jugarPartida(reglas, azar);
+		if(ganador == reglas.jugadores){
+			local.empates++;
+		}else{
+			local.victorias[ganador]++;
+		}
+		local.partidas++;
+	}
+	resultado.sumar(local);
+}
+
+inline unsigned int SimuladorTorneos::jugarPartida(const ReglasTorneo& reglas, GeneradorAzar& azar){
+	int n = reglas.jugadores;
+	// las mesas chicas no piden memoria al heap
+	CartasEnlazadas<unsigned int, 16> mesa;
+	for(unsigned int j = 0; j < reglas.jugadores; j++){
+		mesa.agregarJugador(j);
+	}
+	for(unsigned int r = 1; r <= reglas.rondas; r++){
+		mesa.adelantarMazoRojo(azar.entre(1, n));
+		mesa.adelantarMazoAzul(azar.entre(1, n));
+		mesa.sumarPuntosAlJugador(mesa.dameJugadorConMazoRojo(), azar.entre(1, reglas.puntosMaximos));
+		if(reglas.eliminarCada != 0 && r % reglas.eliminarCada == 0 && mesa.tamanio() > 2){
+			mesa.eliminarJugadorConMazoAzul();
+		}
+	}
+	vector<unsigned int> primeros = mesa.mejoresJugadores(2);
+	if(primeros.size() == 2 && mesa.puntosDelJugador(primeros[0]) == mesa.puntosDelJugador(primeros[1])){
+		return reglas.jugadores;
+	}
+	return mesa.ganador();
+}
+
+#endif // SIMULADOR_TORNEOS_H_
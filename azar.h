@@ -0,0 +1,59 @@
+#ifndef AZAR_H_
+#define AZAR_H_
+
+#include <cassert>
+using namespace std;
+
+/**
+ * Generador de números pseudoaleatorios (xorshift64*). Es chico, rápido y da
+ * la misma secuencia en cualquier plataforma, así que una simulación con la
+ * misma semilla siempre da el mismo resultado.
+ */
+class GeneradorAzar {
+
+  public:
+
+	/**
+	 * Crea el generador del flujo numero de la semilla. Flujos distintos de
+	 * una misma semilla son independientes entre sí.
+	 */
+	GeneradorAzar(unsigned long long semilla, unsigned long long flujo) {
+		estado = mezclar(semilla ^ mezclar(flujo + 1));
+		if(estado == 0){
+			estado = 1;
+		}
+	}
+
+	unsigned long long siguiente() {
+		estado ^= estado >> 12;
+		estado ^= estado << 25;
+		estado ^= estado >> 27;
+		return estado * 2685821657736338717ULL;
+	}
+
+	/**
+	 * Devuelve un entero entre desde y hasta, ambos incluidos.
+	 * PRE: desde <= hasta
+	 */
+	int entre(int desde, int hasta) {
+		assert(desde <= hasta);
+		unsigned long long rango = (unsigned long long)((long long)hasta - desde) + 1;
+		return (int)(desde + (long long)(siguiente() % rango));
+	}
+
+  private:
+
+	/**
+	 * splitmix64: reparte bien semillas parecidas (0, 1, 2, ...).
+	 */
+	static unsigned long long mezclar(unsigned long long x) {
+		x += 0x9E3779B97F4A7C15ULL;
+		x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+		return x ^ (x >> 31);
+	}
+
+	unsigned long long estado;
+};
+
+#endif // AZAR_H_
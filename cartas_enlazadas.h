@@ -1,17 +1,583 @@
 #ifndef CARTAS_ENLAZADAS_H_
 #define CARTAS_ENLAZADAS_H_
 
+#include <algorithm>
 #include <iostream>
 #include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <map>
 using namespace std;
 #include <string>
+#include <new>
+#include <vector>
+#include "CanalDeCambios.h"
+#include "claves.h"
+#include "manijas.h"
+#include "memoria.h"
 
 typedef unsigned long Nat;
+/*
+ * Reserva lugar para N nodos dentro del propio objeto. Los nodos se construyen
+ * ahí mientras haya lugar y recién después se piden al heap, así una mesa
+ * chica no hace ninguna asignación de memoria.
+ */
+template <typename Nodo, Nat N>
+class AlmacenNodos {
+  public:
+	AlmacenNodos() : libres(N) {
+		for(Nat i=0;i<N;i++){
+			pilaLibres[i]=N-1-i;
+		}
+	}
+
+	template <typename A>
+	Nodo* crear(const A& a) {
+		if(libres==0){
+			return crearNodo<Nodo>(a);
+		}
+		libres--;
+		return new (datos + pilaLibres[libres]*sizeof(Nodo)) Nodo(a);
+	}
+
+	void destruir(Nodo* n) {
+		if(esPropio(n)){
+			n->~Nodo();
+			pilaLibres[libres]=((unsigned char*)n - datos)/sizeof(Nodo);
+			libres++;
+		}else{
+			destruirNodo(n);
+		}
+	}
+
+	/*
+	 * Cantidad de nodos construidos dentro del almacén.
+	 */
+	Nat enUso() const { return N-libres; }
+
+	/*
+	 * Dice si el nodo vive dentro del almacén (y no en el heap).
+	 */
+	bool esPropio(const Nodo* n) const {
+		const unsigned char* c=(const unsigned char*)n;
+		return c>=datos && c<datos+N*sizeof(Nodo);
+	}
+
+  private:
+	AlmacenNodos(const AlmacenNodos&);
+	AlmacenNodos& operator=(const AlmacenNodos&);
+
+	alignas(Nodo) unsigned char datos[N*sizeof(Nodo)];
+	unsigned int pilaLibres[N];
+	Nat libres;
+};
+
+/*
+ * Sin lugar reservado todos los nodos van al heap.
+ */
+template <typename Nodo>
+class AlmacenNodos<Nodo, 0> {
+  public:
+	AlmacenNodos() {}
+
+	template <typename A>
+	Nodo* crear(const A& a) { return crearNodo<Nodo>(a); }
+
+	void destruir(Nodo* n) { destruirNodo(n); }
+
+	bool esPropio(const Nodo*) const { return false; }
+
+	Nat enUso() const { return 0; }
+
+  private:
+	AlmacenNodos(const AlmacenNodos&);
+	AlmacenNodos& operator=(const AlmacenNodos&);
+};
+
+/*
+ * Árbol de Fenwick sobre n posiciones que arrancan todas en 1. Permite
+ * descontar una posición y encontrar la k-ésima que sigue en pie en O(log n).
+ */
+class ArbolFenwick {
+  public:
+	ArbolFenwick(Nat n) : arbol(n+1, 0) {
+		for(Nat i=1;i<=n;i++){
+			arbol[i]+=1;
+			Nat padre=i+(i & (~i+1));
+			if(padre<=n){
+				arbol[padre]+=arbol[i];
+			}
+		}
+	}
+
+	/*
+	 * Suma delta a la posición i (empezando en 0).
+	 */
+	void sumar(Nat i, long delta) {
+		for(Nat j=i+1;j<arbol.size();j+=j & (~j+1)){
+			arbol[j]+=delta;
+		}
+	}
+
+	/*
+	 * Devuelve la posición de la k-ésima unidad (empezando en 0).
+	 * PRE: k es menor que la suma total.
+	 */
+	Nat buscar(Nat k) const {
+		Nat pos=0;
+		Nat paso=1;
+		while(paso*2<arbol.size()){
+			paso*=2;
+		}
+		long resto=k;
+		for(;paso>0;paso/=2){
+			if(pos+paso<arbol.size() && arbol[pos+paso]<=resto){
+				pos+=paso;
+				resto-=arbol[pos];
+			}
+		}
+		return pos;
+	}
+
+  private:
+	vector<long> arbol;
+};
+
+/*
+ * Índice de puntajes: treap ordenado por (puntaje, ranura) con el tamaño de
+ * cada subárbol, para contar y listar jugadores por puntaje en O(log n).
+ * Las entradas se guardan en un vector indexado por la ranura del jugador.
+ */
+class IndicePuntajes {
+  public:
+	IndicePuntajes() : raiz(-1), semilla(2463534242u) {}
+
+	void insertar(unsigned int r, int puntaje) {
+		if(r>=e.size()){
+			e.resize(r+1);
+		}
+		e[r].puntaje=puntaje;
+		e[r].prioridad=azar();
+		e[r].tam=1;
+		e[r].izq=-1;
+		e[r].der=-1;
+		int menores, mayores;
+		partir(raiz,puntaje,r,menores,mayores);
+		raiz=unir(unir(menores,r),mayores);
+	}
+
+	/*
+	 * PRE: la ranura está en el índice.
+	 */
+	void quitar(unsigned int r) {
+		int menores, iguales, mayores;
+		partir(raiz,e[r].puntaje,r,menores,mayores);
+		partir(mayores,e[r].puntaje,r+1,iguales,mayores);
+		raiz=unir(menores,mayores);
+	}
+
+	void vaciar() {
+		e.clear();
+		raiz=-1;
+	}
+
+	Nat cantidad() const { return tam(raiz); }
+
+	/*
+	 * Cantidad de entradas con puntaje menor (o menor o igual) a p.
+	 */
+	Nat contarMenores(int p, bool incluido) const {
+		Nat c=0;
+		int t=raiz;
+		while(t>=0){
+			if(e[t].puntaje<p || (incluido && e[t].puntaje==p)){
+				c+=tam(e[t].izq)+1;
+				t=e[t].der;
+			}else{
+				t=e[t].izq;
+			}
+		}
+		return c;
+	}
+
+	/*
+	 * Agrega a res las ranuras de las k entradas de mayor puntaje, de mayor
+	 * a menor, en O(log n + k).
+	 */
+	void mayores(Nat k, vector<unsigned int>& res) const {
+		mayores(raiz,k,res);
+	}
+
+	/*
+	 * PRE: el índice no está vacío.
+	 */
+	unsigned int maximo() const {
+		int t=raiz;
+		while(e[t].der>=0){
+			t=e[t].der;
+		}
+		return t;
+	}
+
+	size_t memoriaUtilizada() const { return e.capacity()*sizeof(Entrada); }
+
+  private:
+	struct Entrada {
+		int puntaje;
+		unsigned int prioridad;
+		Nat tam;
+		int izq;
+		int der;
+	};
+
+	Nat tam(int t) const { return t<0 ? 0 : e[t].tam; }
+
+	void actualizar(int t) { e[t].tam=tam(e[t].izq)+1+tam(e[t].der); }
+
+	unsigned int azar() {
+		semilla^=semilla<<13;
+		semilla^=semilla>>17;
+		semilla^=semilla<<5;
+		return semilla;
+	}
+
+	/*
+	 * Separa el árbol t en las entradas menores que (p, r) y las demás.
+	 */
+	void partir(int t, int p, unsigned int r, int& menores, int& resto) {
+		if(t<0){
+			menores=-1;
+			resto=-1;
+			return;
+		}
+		if(e[t].puntaje<p || (e[t].puntaje==p && (unsigned int)t<r)){
+			partir(e[t].der,p,r,e[t].der,resto);
+			menores=t;
+		}else{
+			partir(e[t].izq,p,r,menores,e[t].izq);
+			resto=t;
+		}
+		actualizar(t);
+	}
+
+	/*
+	 * PRE: todas las entradas de a son menores que las de b.
+	 */
+	int unir(int a, int b) {
+		if(a<0){
+			return b;
+		}
+		if(b<0){
+			return a;
+		}
+		if(e[a].prioridad>e[b].prioridad){
+			int der=unir(e[a].der,b);
+			e[a].der=der;
+			actualizar(a);
+			return a;
+		}
+		int izq=unir(a,e[b].izq);
+		e[b].izq=izq;
+		actualizar(b);
+		return b;
+	}
+
+	void mayores(int t, Nat k, vector<unsigned int>& res) const {
+		if(t<0 || res.size()>=k){
+			return;
+		}
+		mayores(e[t].der,k,res);
+		if(res.size()<k){
+			res.push_back(t);
+			mayores(e[t].izq,k,res);
+		}
+	}
+
+	vector<Entrada> e;
+	int raiz;
+	unsigned int semilla;
+};
+
+/*
+ * Secuencia de asientos en el orden de la ronda: treap implícito (ordenado
+ * por posición) con la suma de cada subárbol y una suma pendiente para todo
+ * el subárbol, así que insertar, quitar, sumar a un rango de posiciones y
+ * sumar un rango cuestan O(log n). Las entradas se guardan en un vector
+ * indexado por la ranura del jugador y conocen a su padre, para llegar de
+ * una ranura a su posición en O(log n).
+ */
+class ArbolDeAsientos {
+  public:
+	ArbolDeAsientos() : raiz(-1), semilla(88172645u) {}
+
+	void vaciar() {
+		e.clear();
+		raiz=-1;
+	}
+
+	Nat cantidad() const { return tam(raiz); }
+
+	/*
+	 * Inserta la ranura r con valor v en la posición i; las que estaban de
+	 * i en adelante se corren un lugar.
+	 * PRE: i <= cantidad()
+	 */
+	void insertar(Nat i, unsigned int r, long v) {
+		if(r>=e.size()){
+			e.resize(r+1);
+		}
+		e[r].valor=v;
+		e[r].suma=v;
+		e[r].pendiente=0;
+		e[r].prioridad=azar();
+		e[r].tam=1;
+		e[r].izq=-1;
+		e[r].der=-1;
+		e[r].padre=-1;
+		int a, b;
+		partir(raiz,i,a,b);
+		raiz=unir(unir(a,r),b);
+		e[raiz].padre=-1;
+	}
+
+	/*
+	 * PRE: la ranura está en el árbol.
+	 */
+	void quitar(unsigned int r) {
+		int a, b, c;
+		partir(raiz,posicion(r),a,b);
+		partir(b,1,b,c);
+		raiz=unir(a,c);
+		if(raiz>=0){
+			e[raiz].padre=-1;
+		}
+	}
+
+	/*
+	 * Posición (empezando en 0) de la ranura r.
+	 */
+	Nat posicion(unsigned int r) const {
+		Nat p=tam(e[r].izq);
+		int t=r;
+		while(e[t].padre>=0){
+			int padre=e[t].padre;
+			if(e[padre].der==t){
+				p+=tam(e[padre].izq)+1;
+			}
+			t=padre;
+		}
+		return p;
+	}
+
+	/*
+	 * Ranura que está en la posición i.
+	 * PRE: i < cantidad()
+	 */
+	unsigned int ranuraEn(Nat i) const {
+		int t=raiz;
+		while(tam(e[t].izq)!=i){
+			if(i<tam(e[t].izq)){
+				t=e[t].izq;
+			}else{
+				i-=tam(e[t].izq)+1;
+				t=e[t].der;
+			}
+		}
+		return t;
+	}
+
+	/*
+	 * Valor de la ranura r, con lo pendiente de sus ancestros.
+	 */
+	long valor(unsigned int r) const {
+		long v=e[r].valor;
+		for(int t=e[r].padre;t>=0;t=e[t].padre){
+			v+=e[t].pendiente;
+		}
+		return v;
+	}
+
+	/*
+	 * Suma d al valor de la ranura r.
+	 */
+	void sumarValor(unsigned int r, long d) {
+		e[r].valor+=d;
+		for(int t=r;t>=0;t=e[t].padre){
+			e[t].suma+=d;
+		}
+	}
+
+	/*
+	 * Suma de las n posiciones que empiezan en i.
+	 * PRE: i + n <= cantidad()
+	 */
+	long suma(Nat i, Nat n) const {
+		return prefijo(i+n)-prefijo(i);
+	}
+
+	/*
+	 * Suma d a las n posiciones que empiezan en i.
+	 * PRE: i + n <= cantidad()
+	 */
+	void sumar(Nat i, Nat n, long d) {
+		int a, b, c;
+		partir(raiz,i,a,b);
+		partir(b,n,b,c);
+		if(b>=0){
+			aplicar(b,d);
+		}
+		raiz=unir(unir(a,b),c);
+		if(raiz>=0){
+			e[raiz].padre=-1;
+		}
+	}
+
+	size_t memoriaUtilizada() const { return e.capacity()*sizeof(Entrada); }
+
+  private:
+	struct Entrada {
+		long valor;
+		long suma;
+		long pendiente;
+		unsigned int prioridad;
+		Nat tam;
+		int izq;
+		int der;
+		int padre;
+	};
+
+	Nat tam(int t) const { return t<0 ? 0 : e[t].tam; }
+
+	long sumaDe(int t) const { return t<0 ? 0 : e[t].suma; }
+
+	void actualizar(int t) {
+		e[t].tam=tam(e[t].izq)+1+tam(e[t].der);
+		e[t].suma=sumaDe(e[t].izq)+e[t].valor+sumaDe(e[t].der);
+	}
+
+	void aplicar(int t, long d) {
+		e[t].valor+=d;
+		e[t].suma+=d*(long)e[t].tam;
+		e[t].pendiente+=d;
+	}
+
+	void empujar(int t) {
+		if(e[t].pendiente!=0){
+			if(e[t].izq>=0){
+				aplicar(e[t].izq,e[t].pendiente);
+			}
+			if(e[t].der>=0){
+				aplicar(e[t].der,e[t].pendiente);
+			}
+			e[t].pendiente=0;
+		}
+	}
+
+	unsigned int azar() {
+		semilla^=semilla<<13;
+		semilla^=semilla>>17;
+		semilla^=semilla<<5;
+		return semilla;
+	}
+
+	/*
+	 * Suma de las primeras k posiciones, sin modificar el árbol.
+	 */
+	long prefijo(Nat k) const {
+		long s=0;
+		// lo pendiente de los ancestros estrictos de t
+		long arriba=0;
+		int t=raiz;
+		while(t>=0 && k>0){
+			Nat izq=tam(e[t].izq);
+			long conT=arriba+e[t].pendiente;
+			if(k<=izq){
+				t=e[t].izq;
+			}else{
+				s+=sumaDe(e[t].izq)+conT*(long)izq+e[t].valor+arriba;
+				k-=izq+1;
+				t=e[t].der;
+			}
+			arriba=conT;
+		}
+		return s;
+	}
+
+	/*
+	 * Separa las primeras k posiciones de t del resto.
+	 */
+	void partir(int t, Nat k, int& a, int& b) {
+		if(t<0){
+			a=-1;
+			b=-1;
+			return;
+		}
+		empujar(t);
+		if(tam(e[t].izq)<k){
+			int der;
+			partir(e[t].der,k-tam(e[t].izq)-1,der,b);
+			e[t].der=der;
+			if(der>=0){
+				e[der].padre=t;
+			}
+			a=t;
+		}else{
+			int izq;
+			partir(e[t].izq,k,a,izq);
+			e[t].izq=izq;
+			if(izq>=0){
+				e[izq].padre=t;
+			}
+			b=t;
+		}
+		actualizar(t);
+	}
+
+	int unir(int a, int b) {
+		if(a<0){
+			return b;
+		}
+		if(b<0){
+			return a;
+		}
+		if(e[a].prioridad>e[b].prioridad){
+			empujar(a);
+			int der=unir(e[a].der,b);
+			e[a].der=der;
+			e[der].padre=a;
+			actualizar(a);
+			return a;
+		}
+		empujar(b);
+		int izq=unir(a,e[b].izq);
+		e[b].izq=izq;
+		e[izq].padre=b;
+		actualizar(b);
+		return b;
+	}
+
+	vector<Entrada> e;
+	int raiz;
+	unsigned int semilla;
+};
+
 /* 
  * Se puede asumir que el tipo T tiene constructor por copia y operator==
  * No se puede asumir que el tipo T tenga operator=
+ *
+ * N es la cantidad de jugadores que se guardan dentro del propio objeto
+ * (sin usar el heap). Con N = 0 todos los jugadores se piden al heap.
+ *
+ * Los movimientos de los mazos no recorren la ronda en el momento: se
+ * acumulan como un desplazamiento pendiente (módulo la cantidad de
+ * jugadores) y se resuelven con un único recorrido, por el camino más
+ * corto, cuando una consulta o un cambio en la mesa necesita la posición.
+ * Por eso las consultas const no son sólo de lectura: resuelven los mazos y
+ * los cursores pendientes y arman los índices de puntajes y de asientos, que
+ * son mutable. Varios hilos pueden consultar el mismo juego a la vez sólo si
+ * antes se dejó todo resuelto, como hace CartasPublicadas con cada versión.
  */
-template <typename T>
+template <typename T, Nat N = 0>
 
 class CartasEnlazadas {
 
@@ -26,7 +592,7 @@ class CartasEnlazadas {
 	 * Una vez copiada, ambos juegos deben ser independientes, 
 	 * es decir, cuando se borre una no debe borrar la otra.
 	 */	
-	CartasEnlazadas(const CartasEnlazadas<T>&);
+	CartasEnlazadas(const CartasEnlazadas<T, N>&);
 	
 	/**
 	 * Acordarse de liberar toda la memoria!
@@ -38,10 +604,11 @@ class CartasEnlazadas {
 	* siguiente a la posición del jugador con el mazo azul. Por ejemplo si en la
 	* mesa hay 3 jugadores sentados de la siguiente forma: [j1 j2 j3], y el 
 	* mazo rojo lo tiene el jugador j3, la mesa debe quedar: [j1 j2 j3 j4].
+	* Devuelve una manija para operar sobre el jugador en O(1).
 	* PRE: el jugador a agregar no existe.
 	*/
-	void agregarJugador(const T& jugador);
-	
+	Manija agregarJugador(const T& jugador);
+
 	/**
 	* Adelanta el mazo rojo n posiciones. Por ejemplo: si en la mesa hay 3 
 	* jugadores sentados de la siguiente forma: [j1 j2 j3] y el jugador j2
@@ -90,6 +657,64 @@ class CartasEnlazadas {
 	* PRE: cantidad de jugadores par, al menos un jugador
 	*/
 	const T& dameJugadorEnfrentado() const;
+
+	/**
+	* Crea un cursor con nombre, además de los dos mazos (un mazo extra, el
+	* botón del que reparte, una marca...), y devuelve su número. Arranca en
+	* el jugador con el mazo azul. Si la mesa se vacía los cursores quedan
+	* sin jugador y pasan al primero que se siente.
+	* Como los mazos, moverlo cuesta O(1) y el recorrido se hace recién
+	* cuando se consulta el cursor o cambia la mesa; consultar un cursor ya
+	* resuelto cuesta O(1). Cada jugador lleva la lista de sus cursores:
+	* cuando se va de la mesa sus cursores pasan al siguiente de la ronda y
+	* sólo se tocan esos.
+	* PRE: no hay otro cursor con ese nombre.
+	*/
+	Nat crearCursor(const string& nombre);
+
+	/**
+	* PRE: el cursor existe.
+	*/
+	void eliminarCursor(Nat cursor);
+
+	/**
+	* Número del cursor con ese nombre.
+	* PRE: hay un cursor con ese nombre.
+	*/
+	Nat cursor(const string& nombre) const;
+	bool existeCursor(const string& nombre) const;
+	Nat cantidadDeCursores() const;
+
+	/**
+	* PRE: el cursor existe.
+	*/
+	const string& nombreDelCursor(Nat cursor) const;
+
+	/**
+	* Mueve el cursor n lugares (hacia atrás si n es negativo).
+	* PRE: el cursor existe y hay al menos un jugador.
+	*/
+	void moverCursor(Nat cursor, int n);
+
+	/**
+	* Lleva el cursor al jugador.
+	* PRE: el cursor existe y el jugador (o la manija) también.
+	*/
+	void ponerCursor(Nat cursor, const T& jugador);
+	void ponerCursor(Nat cursor, const Manija& m);
+
+	/**
+	* Devuelve el jugador que tiene el cursor.
+	* PRE: el cursor existe y hay al menos un jugador.
+	*/
+	const T& jugadorConCursor(Nat cursor) const;
+
+	/**
+	* Devuelve los cursores que tiene el jugador, en O(cursores de la mesa
+	* que no se consultaron desde que se movieron) más O(los del jugador).
+	* PRE: el jugador existe.
+	*/
+	vector<Nat> cursoresDelJugador(const T&) const;
 	
 	/**
 	* Elimina el jugador pasado como parámetro.
@@ -110,6 +735,15 @@ class CartasEnlazadas {
 	* PRE: al menos un jugador
 	*/
 	void eliminarJugadorConMazoAzul();
+
+	/**
+	* Repite cantidad veces: adelantar el mazo azul k posiciones y eliminar al
+	* jugador con el mazo azul. Devuelve los jugadores eliminados en orden.
+	* Los mazos y los puntajes quedan igual que si se hubieran hecho las
+	* llamadas una por una, pero la secuencia completa cuesta O(n log n).
+	* PRE: cantidad <= tamanio()
+	*/
+	vector<T> eliminarCadaK(int k, Nat cantidad);
 	
 	/**
 	* Dice si el jugador existe.
@@ -128,27 +762,196 @@ class CartasEnlazadas {
 	* PRE: el jugador existe
 	*/
 	int puntosDelJugador(const T&) const;
+
+	/**
+	* Suma puntos a varios jugadores de una vez. Recibe un rango de pares
+	* (jugador, puntos) y deja la mesa igual que si se llamara a
+	* sumarPuntosAlJugador con cada par. Cada jugador se busca a partir del
+	* anterior, así que si los pares vienen en el orden de la ronda (por
+	* ejemplo, armados con los iteradores) el lote entero se resuelve en una
+	* sola vuelta, O(n + m), más la actualización de los índices.
+	* PRE: todos los jugadores existen
+	*/
+	template <typename Iterador>
+	void sumarPuntosEnLote(Iterador desde, Iterador hasta);
+
+	/**
+	* Le suma puntos[i] al jugador que está i lugares después del que tiene
+	* el mazo azul (en el orden de mostrarCartasEnlazadas), en una sola vuelta.
+	* PRE: puntos.size() <= tamanio()
+	*/
+	void sumarPuntosPorAsiento(const vector<int>& puntos);
 	
 	/**
 	* Devuelve al jugador que más puntos tiene.
 	* PRE: hay un único jugador que tiene más puntos que todos los demás.
 	*/
 	const T& ganador() const;
-	
-	/*
-	 * Dice si hay jugadores en la mesa.
-	 */
-	bool esVacia() const;
 
-	/*
-	 * Devuelve la cantidad de jugadores.
-	 */
-	int tamanio() const;	
+	/**
+	* Tabla de posiciones. La primera consulta arma un índice de los puntajes
+	* en O(n log n); desde ahí el índice se mantiene al día en O(log n) con
+	* cada cambio de puntaje y cada jugador que entra o sale, y ganador()
+	* también lo usa.
+	*/
 
-	/*
-	 * Devuelve true si los juegos son iguales.
-	 */
-	bool operator==(const CartasEnlazadas<T>&) const;	
+	/**
+	* Devuelve la posición del jugador en la tabla: 1 más la cantidad de
+	* jugadores con más puntos que él (los empatados comparten posición).
+	* PRE: el jugador existe
+	*/
+	Nat posicionDelJugador(const T&) const;
+	Nat posicionDelJugador(const Manija&) const;
+
+	/**
+	* Versiones de existeJugador, puntosDelJugador y posicionDelJugador que
+	* buscan al jugador por una clave de otro tipo (un id, un string_view con
+	* el nombre) sin construir un T. El jugador buscado es el que da true al
+	* compararlo con la clave mediante ==. Sólo participan si T == K existe.
+	*/
+	template <typename K>
+	typename SiEsClave<T, K, bool>::type existeJugador(const K&) const;
+	template <typename K>
+	typename SiEsClave<T, K, int>::type puntosDelJugador(const K&) const;
+	template <typename K>
+	typename SiEsClave<T, K, Nat>::type posicionDelJugador(const K&) const;
+
+	/**
+	* Devuelve los k jugadores con más puntos, de mayor a menor puntaje (o
+	* todos si hay menos de k). Entre empatados el orden es arbitrario.
+	* Cuesta O(log n + k).
+	*/
+	vector<T> mejoresJugadores(Nat k) const;
+
+	/**
+	* Devuelve la cantidad de jugadores con puntaje entre desde y hasta,
+	* ambos incluidos.
+	*/
+	Nat cantidadDeJugadoresConPuntajeEntre(int desde, int hasta) const;
+	
+	/**
+	* Puntos por arcos de la ronda. Un arco son cantidad jugadores seguidos
+	* (en el sentido en que se adelantan los mazos) a partir del que está desde
+	* posiciones adelante del mazo rojo o del azul, como en dameJugador. La
+	* primera consulta arma un árbol con los puntajes en el orden de la ronda
+	* en O(n log n); desde ahí cada arco cuesta O(log n), y el árbol se mantiene
+	* al día en O(log n) por cada jugador que entra o sale. Sumar puntos a un
+	* arco de hasta tamanio()/4 jugadores corrige la tabla de posiciones en
+	* O(cantidad log n); un arco más largo la deja desactualizada, y se vuelve
+	* a armar en la siguiente consulta.
+	* PRE: existe al menos un jugador y cantidad <= tamanio()
+	*/
+	long puntosDelArcoDesdeMazoRojo(int desde, Nat cantidad) const;
+	long puntosDelArcoDesdeMazoAzul(int desde, Nat cantidad) const;
+	void sumarPuntosAlArcoDesdeMazoRojo(int desde, Nat cantidad, int p);
+	void sumarPuntosAlArcoDesdeMazoAzul(int desde, Nat cantidad, int p);
+
+	/**
+	* Versiones con manija de las operaciones anteriores: llegan al jugador en
+	* O(1) en lugar de buscarlo en la ronda. Las manijas de jugadores ya
+	* eliminados dejan de ser válidas (también si el mismo jugador se vuelve a
+	* sentar) y no valen en una copia del juego.
+	*/
+
+	/**
+	* Dice si la manija corresponde a un jugador en la mesa.
+	*/
+	bool esValida(const Manija&) const;
+
+	/**
+	* Devuelve el jugador de la manija.
+	* PRE: la manija es válida
+	*/
+	const T& jugador(const Manija&) const;
+
+	/**
+	* Si la manija no es válida no hace nada.
+	*/
+	void eliminarJugador(const Manija&);
+
+	/**
+	* PRE: la manija es válida
+	*/
+	void sumarPuntosAlJugador(const Manija&, int);
+
+	/**
+	* PRE: la manija es válida
+	*/
+	int puntosDelJugador(const Manija&) const;
+
+	/*
+	 * Dice si hay jugadores en la mesa.
+	 */
+	bool esVacia() const;
+
+	/*
+	 * Devuelve la cantidad de jugadores.
+	 */
+	int tamanio() const;	
+
+	/*
+	 * Activa o desactiva el borrado diferido, como en PlanificadorRR: con el
+	 * modo activado los jugadores nuevos van a una arena de bloques contiguos
+	 * (en lugar del lugar reservado o del heap), los que salen de la mesa dejan
+	 * una lápida y, cuando hay más lápidas que jugadores, cada agregarJugador y
+	 * eliminarJugador muda unos pocos jugadores a bloques nuevos, en el orden
+	 * de la ronda a partir del mazo azul, hasta poder devolver los viejos.
+	 * Las manijas siguen valiendo después de mudar un jugador.
+	 */
+	void diferirBorrado(bool);
+	bool difiereBorrado() const;
+
+	/*
+	 * Cantidad de lápidas que todavía ocupan lugar en la arena.
+	 */
+	int cantidadDeLapidas() const;
+
+	/*
+	 * Dice si hay una compactación en curso.
+	 */
+	bool estaCompactando() const;
+
+	/*
+	 * Conecta un canal por el que el juego informa cada cambio: agregar y
+	 * eliminar un jugador, adelantar un mazo (con los lugares) y sumarle
+	 * puntos a un jugador (con los puntos). Repetir esos cambios sobre otro
+	 * juego lo deja igual. eliminarCadaK, las transferencias y las sumas a
+	 * arcos, o que el canal se llene, dejan una foto pendiente: el juego
+	 * manda CAMBIO_FOTO, los jugadores como CAMBIO_AGREGAR en el orden en
+	 * que hay que agregarlos para armar la ronda (el del mazo azul primero),
+	 * un CAMBIO_PUNTOS por cada puntaje distinto de cero y un
+	 * CAMBIO_MAZO_ROJO con la distancia del mazo azul al rojo. Mientras la
+	 * foto no entra en el canal no se manda ningún otro cambio: ya quedan en
+	 * la foto. Al conectar un juego con jugadores se manda una foto. Con NULL
+	 * se desconecta; las copias del juego no quedan conectadas.
+	 * PRE: el canal vive mientras esté conectado, este juego es su único
+	 * productor y tiene lugar para la foto y la marca del hueco (2 * tamanio()
+	 * + 3 cambios alcanzan siempre).
+	 */
+	void conectarCanal(CanalDeCambios<T>* canal);
+
+	/*
+	 * Manda la foto pendiente si entra en el canal. Devuelve true si el
+	 * canal quedó al día. El productor la puede llamar cuando quiera.
+	 */
+	bool actualizarCanal();
+
+	/*
+	 * Devuelve la cantidad de bytes que ocupa el juego: el objeto (con el
+	 * lugar reservado para N jugadores), los jugadores que están en el heap
+	 * y los índices. No cuenta la memoria que use cada T por fuera del nodo.
+	 */
+	size_t memoriaUtilizada() const;
+
+	/*
+	 * Devuelve cuántas veces se armó la tabla de posiciones desde cero.
+	 */
+	Nat armadosDelIndice() const { return this->armados; }
+
+	/*
+	 * Devuelve true si los juegos son iguales.
+	 */
+	bool operator==(const CartasEnlazadas<T, N>&) const;	
 	
 	/*
 	 * Debe mostrar la ronda por el ostream (y retornar el mismo).
@@ -159,12 +962,101 @@ class CartasEnlazadas {
 	 * e1 fue agregado antes que e2): [(e1, 0)*, (e3, 0), (e2, 0)]
 	 */
 	ostream& mostrarCartasEnlazadas(ostream&) const;
+
+	/*
+	 * Activa o desactiva el seguimiento de cambios para mostrarCambios, como
+	 * en PlanificadorRR. Las copias del juego no siguen cambios.
+	 */
+	void seguirCambios(bool);
+	bool sigueCambios() const;
+
+	/*
+	 * Muestra lo que cambió desde el mostrarCambios anterior, una línea por
+	 * cambio, con cada jugador en el formato de mostrarCartasEnlazadas:
+	 *   - e      el jugador e salió de la mesa
+	 *   + (e,p)  se sentó el jugador e
+	 *   ~ (e,p)  cambió el puntaje de e
+	 *   R e      e pasó a tener el mazo rojo (R - si la mesa quedó vacía)
+	 *   A e      e pasó a tener el mazo azul (A - si la mesa quedó vacía)
+	 * Primero las bajas, después los jugadores en el orden en que cambiaron
+	 * por primera vez y al final los mazos. Si hubo cambios que no se
+	 * describen así (eliminarCadaK, transferencias, sumas a arcos) o se
+	 * juntaron demasiados, muestra sólo "!" y hay que redibujar todo.
+	 * PRE: sigueCambios()
+	 */
+	ostream& mostrarCambios(ostream&);
+
+	/*
+	 * Muestra hasta cantidad jugadores a partir del de la manija (del que
+	 * tiene el mazo azul si es MANIJA_INVALIDA), con el formato de
+	 * mostrarCartasEnlazadas, y devuelve la manija del jugador con el que
+	 * sigue la página siguiente, o MANIJA_INVALIDA si se llegó al final de la
+	 * ronda.
+	 * PRE: cantidad > 0 y la manija es MANIJA_INVALIDA o es válida.
+	 */
+	Manija mostrarPagina(ostream&, const Manija& desde, Nat cantidad) const;
+
+	class const_iterator;
+	class Vista;
+
+	/*
+	 * Iteradores bidireccionales sobre los jugadores, en el mismo orden en que
+	 * los muestra mostrarCartasEnlazadas (empezando por el que tiene el mazo
+	 * azul). Recorren la ronda en el lugar, sin copiar jugadores.
+	 * Cualquier modificación del juego invalida los iteradores.
+	 */
+	const_iterator begin() const;
+	const_iterator end() const;
+
+	/*
+	 * Vista de la ronda comenzando por el jugador con el mazo rojo.
+	 */
+	Vista vistaDesdeMazoRojo() const;
+
+	/*
+	 * Vista de la ronda comenzando por el jugador con el mazo azul.
+	 */
+	Vista vistaDesdeMazoAzul() const;
+
+	/**
+	* Saca de origen los cantidad jugadores consecutivos que empiezan en
+	* primero y los sienta, en el mismo orden y con sus puntajes, a
+	* continuación del jugador con el mazo azul de esta mesa. Los mazos de
+	* origen que tenía alguno de ellos pasan al siguiente jugador que queda
+	* allá. Cuesta O(cantidad): el arco se corta y se enlaza con unos pocos
+	* punteros, pero cada jugador movido se descuenta de origen y se registra
+	* con una manija nueva, y los guardados dentro del objeto origen se
+	* copian. Las manijas de los jugadores movidos dejan de valer. Que los
+	* movidos no estén ya en esta mesa no se verifica.
+	* PRE: origen no es esta mesa.
+	* PRE: primero existe en origen y 0 < cantidad <= origen.tamanio().
+	* PRE: ninguno de los jugadores movidos existe en esta mesa.
+	*/
+	void transferirJugadores(CartasEnlazadas<T, N>& origen, const T& primero, Nat cantidad);
+	void transferirJugadores(CartasEnlazadas<T, N>& origen, const Manija& primero, Nat cantidad);
+
+	/**
+	* Mueve todos los jugadores de otra mesa a esta (empezando por el que tiene
+	* el mazo azul allá), como transferirJugadores. La otra mesa queda vacía.
+	* PRE: otra no es esta mesa y no comparten jugadores.
+	*/
+	void unir(CartasEnlazadas<T, N>& otra);
+
+	/**
+	* Mueve a destino los jugadores que cumplen el predicado, en el orden de la
+	* ronda empezando por el mazo azul, y los sienta a continuación del mazo
+	* azul de destino. Los mazos pasan como en eliminarJugador.
+	* PRE: destino no es esta mesa y no tiene a ninguno de los movidos.
+	*/
+	template <typename Predicado>
+	void separar(CartasEnlazadas<T, N>& destino, Predicado cumple);
+
   private:
   
 	/*
 	 * No se puede modificar esta funcion.
 	 */
-	CartasEnlazadas<T>& operator=(const CartasEnlazadas<T>& otra) {
+	CartasEnlazadas<T, N>& operator=(const CartasEnlazadas<T, N>& otra) {
 		assert(false);
 		return *this;
 	}
@@ -177,19 +1069,298 @@ class CartasEnlazadas {
     	Nodo* siguiente;
     	Nodo* anterior;
     	int puntaje;
-    	Nodo (const T& a) :jugador(a) , puntaje(0), siguiente(NULL), anterior(NULL){};
+    	// la marca para mostrarCambios va en los bits altos de la ranura
+    	unsigned int ranura : 30;
+    	unsigned int marca : 2;
+    	Nodo (const T& a) :jugador(a) , siguiente(NULL), anterior(NULL), puntaje(0), ranura(0), marca(LIMPIO){};
     	
  
     };
 
+	/*
+	 * Aplica los desplazamientos pendientes de ambos mazos y de los cursores.
+	 */
+	void resolverMazos() const;
+
+	/*
+	 * Cursor creado con crearCursor. Los cursores de un mismo jugador forman
+	 * una lista doblemente enlazada por número; los de la mesa vacía, otra.
+	 */
+	struct DatosCursor {
+		string nombre;
+		// NULL si la mesa está vacía o el cursor no está en uso
+		Nodo* nodo;
+		long pendiente;
+		Nat siguiente;
+		Nat anterior;
+		bool enUso;
+		// está en cursoresPendientes
+		bool esperando;
+	};
+
+	static const Nat SIN_CURSOR = ~0ul;
+
+	/*
+	 * Primer cursor de la lista de cursores de un nodo (o la de los cursores
+	 * sin jugador si el nodo es NULL). La versión que se puede escribir
+	 * agranda la tabla hasta la ranura del nodo; la de lectura no.
+	 */
+	Nat& primerCursorDe(Nodo* nodo) const;
+	Nat leerPrimerCursor(const Nodo* nodo) const;
+
+	/*
+	 * Registra el nodo en una ranura libre.
+	 */
+	Manija registrarNodo(Nodo* nodo);
+
+	/*
+	 * Engancha el cursor en la lista del nodo o lo desengancha de la suya.
+	 */
+	void engancharCursor(Nat c, Nodo* nodo) const;
+	void desengancharCursor(Nat c) const;
+
+	/*
+	 * Aplica el desplazamiento pendiente del cursor.
+	 */
+	void resolverCursor(Nat c) const;
+
+	/*
+	 * Pasa todos los cursores del nodo a la lista de otro (NULL: sin jugador).
+	 */
+	void mudarCursores(Nodo* desde, Nodo* hacia);
+
+	/*
+	 * Devuelve el nodo que está n posiciones adelante (atrás si n es negativo)
+	 * de desde, recorriendo la ronda en la dirección más corta.
+	 */
+	Nodo* avanzar(Nodo* desde, long n) const;
+
+	/*
+	 * Devuelve el nodo del jugador (o del que es igual a la clave), o NULL
+	 * si no está en la mesa.
+	 */
+	template <typename K>
+	Nodo* buscar(const K& jugador) const;
+
+	/*
+	 * Saca al nodo de la ronda pasándole sus mazos al siguiente y lo libera.
+	 * PRE: no hay desplazamientos de mazos pendientes.
+	 */
+	void quitarNodo(Nodo* nodo);
+
+	/*
+	 * Crean y liberan nodos en la arena, en el almacén o en el heap según
+	 * corresponda. liberarNodo arranca la compactación si hay demasiadas
+	 * lápidas.
+	 */
+	Nodo* nuevoNodo(const T& jugador);
+	void liberarNodo(Nodo* nodo);
+
+	/*
+	 * Muda unos pocos nodos de la compactación en curso.
+	 */
+	void compactarPaso();
+
+	/*
+	 * Reemplaza al nodo por una copia en la generación actual de la arena, en
+	 * el mismo asiento y con la misma ranura.
+	 */
+	void reubicar(Nodo* nodo);
+
+	/*
+	 * Saca al nodo de la ronda pasándole sus mazos al siguiente, sin liberarlo.
+	 * PRE: no hay desplazamientos de mazos pendientes.
+	 */
+	void desenlazar(Nodo* nodo);
+
+	/*
+	 * Corta del anillo el arco de cantidad nodos que empieza en primero;
+	 * los mazos que estaban en el arco pasan al siguiente que queda.
+	 * PRE: no hay desplazamientos de mazos pendientes.
+	 */
+	void cortarArco(Nodo* primero, Nat cantidad);
+
+	/*
+	 * Toma los cantidad nodos encadenados por siguiente desde primero, que ya
+	 * no están en la ronda de origen: libera sus ranuras allá, los registra
+	 * acá (copiando los que vivían dentro de origen) y los sienta en orden a
+	 * continuación del mazo azul.
+	 */
+	void adoptarCadena(CartasEnlazadas<T, N>& origen, Nodo* primero, Nat cantidad);
+
+	/*
+	 * Arma el índice de puntajes si no está al día.
+	 */
+	void indexar() const;
+
+	/*
+	 * Mantienen el índice de puntajes (si ya se armó) cuando un jugador
+	 * entra o sale de la mesa.
+	 */
+	void indexarAlta(const Nodo* nodo);
+	void indexarBaja(const Nodo* nodo);
+
+	/*
+	 * Suma puntos al jugador del nodo manteniendo el índice.
+	 */
+	void sumarPuntos(Nodo* nodo, int p);
+
+	/*
+	 * Informa un cambio por el canal, si hay uno conectado.
+	 */
+	void informar(TipoDeCambio tipo, long valor);
+	void informar(TipoDeCambio tipo, Nodo* nodo, long valor);
+
+	/*
+	 * Manda el cambio por el canal, antes la foto pendiente si hay una. Si
+	 * el cambio ya se aplicó y la foto salió recién, no hace falta mandarlo.
+	 */
+	void emitir(const Cambio<T>& cambio, bool yaAplicado);
+
+	/*
+	 * Marcas de los nodos para mostrarCambios.
+	 */
+	enum Marca { LIMPIO, NUEVO, CAMBIADO };
+
+	/*
+	 * Anota el nodo para el próximo mostrarCambios, si no estaba anotado.
+	 */
+	void marcar(Nodo* nodo, Marca m);
+
+	/*
+	 * Descarta lo anotado: el próximo mostrarCambios pide redibujar todo.
+	 */
+	void desbordar();
+
+	/*
+	 * Muestra al jugador del nodo como mostrarCartasEnlazadas, sin el *.
+	 */
+	void mostrarJugador(ostream& os, const Nodo* nodo) const;
+
+	/*
+	 * Puntaje del jugador del nodo. Mientras el árbol de asientos está armado
+	 * el puntaje vive ahí (puede tener sumas de arcos pendientes) y el del
+	 * nodo recién se actualiza cuando el jugador sale de la mesa.
+	 */
+	int puntajeDe(const Nodo* nodo) const;
+
+	/*
+	 * Arma el árbol de asientos si no está al día.
+	 */
+	void armarAsientos() const;
+
+	/*
+	 * Posición en el árbol de asientos del jugador que está desde lugares
+	 * adelante del nodo, contando el desplazamiento pendiente del mazo.
+	 */
+	Nat posicionEnRonda(const Nodo* nodo, long desde) const;
+
+	/*
+	 * Suma de los puntos de cantidad posiciones seguidas a partir de inicio (o
+	 * les suma p), dando la vuelta por el final de la ronda si hace falta.
+	 */
+	long sumaDeArco(Nat inicio, Nat cantidad) const;
+	void sumarArco(Nat inicio, Nat cantidad, int p);
+
+	AlmacenNodos<Nodo, N> almacen;
+	ArenaNodos<Nodo> arena;
+	bool borradoDiferido;
+	// próximo nodo a mudar, o NULL si no se está compactando
+	Nodo* compactando;
+	CanalDeCambios<T>* canal;
+	bool fotoPendiente;
+	// seguimiento de cambios para mostrarCambios
+	bool siguiendo;
+	bool desbordado;
+	vector<Manija> sucios;
+	vector<T> quitados;
+	Manija rojoMostrado;
+	Manija azulMostrado;
+	TablaDeManijas<Nodo> manijas;
     Nat len;
-	Nodo* jMazoAzul;
-	Nodo* jMazoRojo;
+	mutable Nodo* jMazoAzul;
+	mutable Nodo* jMazoRojo;
+	mutable long pendienteAzul;
+	mutable long pendienteRojo;
+	mutable IndicePuntajes indice;
+	mutable bool indiceAlDia;
+	mutable Nat armados;
+	mutable ArbolDeAsientos asientos;
+	mutable bool asientosAlDia;
+	mutable vector<DatosCursor> cursores;
+	// cursores movidos que todavía no se recorrieron
+	mutable vector<Nat> cursoresPendientes;
+	vector<Nat> cursoresLibres;
+	map<string, Nat> nombresDeCursores;
+	mutable Nat cursoresSinJugador;
+	// primer cursor de cada jugador, por ranura; vacía mientras no haya cursores
+	mutable vector<Nat> primerosCursores;
+
+  public:
+
+	/*
+	 * Recorre la ronda a partir de un nodo. Lleva la cuenta de los pasos
+	 * dados para distinguir el final de la vuelta del comienzo.
+	 */
+	class const_iterator {
+	  public:
+		typedef std::bidirectional_iterator_tag iterator_category;
+		typedef T value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const T* pointer;
+		typedef const T& reference;
+
+		const_iterator() : juego(NULL), nodo(NULL), pasos(0) {}
+
+		reference operator*() const { return nodo->jugador; }
+		pointer operator->() const { return &(nodo->jugador); }
+
+		/*
+		 * Puntaje del jugador apuntado.
+		 */
+		int puntaje() const { return juego->puntajeDe(nodo); }
+
+		bool tieneMazoRojo() const { return nodo == juego->jMazoRojo; }
+		bool tieneMazoAzul() const { return nodo == juego->jMazoAzul; }
+
+		const_iterator& operator++() { nodo = nodo->siguiente; pasos++; return *this; }
+		const_iterator operator++(int) { const_iterator res(*this); ++(*this); return res; }
+		const_iterator& operator--() { nodo = nodo->anterior; pasos--; return *this; }
+		const_iterator operator--(int) { const_iterator res(*this); --(*this); return res; }
+
+		bool operator==(const const_iterator& otro) const { return nodo == otro.nodo && pasos == otro.pasos; }
+		bool operator!=(const const_iterator& otro) const { return !(*this == otro); }
+
+	  private:
+		friend class CartasEnlazadas<T, N>;
+		const_iterator(const CartasEnlazadas<T, N>* j, const Nodo* n, Nat i) : juego(j), nodo(n), pasos(i) {}
+
+		const CartasEnlazadas<T, N>* juego;
+		const Nodo* nodo;
+		Nat pasos;
+	};
+
+	/*
+	 * Par de iteradores liviano (no es dueño de ningún jugador).
+	 */
+	class Vista {
+	  public:
+		const_iterator begin() const { return inicio; }
+		const_iterator end() const { return fin; }
+		bool empty() const { return inicio == fin; }
+
+	  private:
+		friend class CartasEnlazadas<T, N>;
+		Vista(const const_iterator& i, const const_iterator& f) : inicio(i), fin(f) {}
+
+		const_iterator inicio;
+		const_iterator fin;
+	};
 };
 
 
-template<class T>
-ostream& operator<<(ostream& out, const CartasEnlazadas<T>& a) {
+template <typename T, Nat N>
+ostream& operator<<(ostream& out, const CartasEnlazadas<T, N>& a) {
 	return a.mostrarCartasEnlazadas(out);
 }
 
@@ -199,15 +1370,38 @@ ostream& operator<<(ostream& out, const CartasEnlazadas<T>& a) {
 // Implementación a hacer por los alumnos.
 
 
-template <typename T>
-CartasEnlazadas<T>::CartasEnlazadas(){
+template <typename T, Nat N>
+CartasEnlazadas<T, N>::CartasEnlazadas(){
 	this->len=0;
 	this->jMazoAzul=NULL;
 	this->jMazoRojo=NULL;
+	this->pendienteAzul=0;
+	this->pendienteRojo=0;
+	this->indiceAlDia=false;
+	this->armados=0;
+	this->asientosAlDia=false;
+	this->borradoDiferido=false;
+	this->compactando=NULL;
+	this->canal=NULL;
+	this->fotoPendiente=false;
+	this->siguiendo=false;
+	this->desbordado=false;
+	this->rojoMostrado=MANIJA_INVALIDA;
+	this->azulMostrado=MANIJA_INVALIDA;
+	this->cursoresSinJugador=SIN_CURSOR;
 }
 
-template <typename T>
-CartasEnlazadas<T>::~CartasEnlazadas(){
+template <typename T, Nat N>
+CartasEnlazadas<T, N>::~CartasEnlazadas(){
+	this->indiceAlDia=false;
+	this->asientosAlDia=false;
+	// que borrar no arranque una compactación
+	this->borradoDiferido=false;
+	this->compactando=NULL;
+	this->canal=NULL;
+	this->siguiendo=false;
+	// los cursores se van con la mesa: no hace falta pasarlos de jugador
+	this->cursores.clear();
 	int i=this->len;
 	while(i>0){
 		eliminarJugadorConMazoAzul();
@@ -215,9 +1409,24 @@ CartasEnlazadas<T>::~CartasEnlazadas(){
 	}
 }
 
-template <typename T>
-CartasEnlazadas<T>::CartasEnlazadas(const CartasEnlazadas<T>& otroJuego){
+template <typename T, Nat N>
+CartasEnlazadas<T, N>::CartasEnlazadas(const CartasEnlazadas<T, N>& otroJuego){
 	int i=otroJuego.len;
+	this->pendienteAzul=0;
+	this->pendienteRojo=0;
+	this->indiceAlDia=false;
+	this->armados=0;
+	this->asientosAlDia=false;
+	this->borradoDiferido=otroJuego.borradoDiferido;
+	this->compactando=NULL;
+	this->canal=NULL;
+	this->fotoPendiente=false;
+	this->siguiendo=false;
+	this->desbordado=false;
+	this->rojoMostrado=MANIJA_INVALIDA;
+	this->azulMostrado=MANIJA_INVALIDA;
+	this->cursoresSinJugador=SIN_CURSOR;
+	otroJuego.resolverMazos();
 	if(i==0){
 		this->len=i;
 		this->jMazoAzul=NULL;
@@ -227,13 +1436,14 @@ CartasEnlazadas<T>::CartasEnlazadas(const CartasEnlazadas<T>& otroJuego){
 		this->jMazoAzul=NULL;
 		this->jMazoRojo=NULL;
 		Nodo* original=otroJuego.jMazoAzul;
-		this->agregarJugador(original->jugador);
-		this->sumarPuntosAlJugador(original->jugador,original->puntaje);
+		// los puntos se suman por manija para no buscar a cada jugador
+		Manija m=this->agregarJugador(original->jugador);
+		this->sumarPuntosAlJugador(m,otroJuego.puntajeDe(original));
 		original=original->siguiente;
 		Nodo* aux=this->jMazoAzul;
 		while(i-1>0){
-			this->agregarJugador(original->jugador);
-			this->sumarPuntosAlJugador(original->jugador,original->puntaje);
+			m=this->agregarJugador(original->jugador);
+			this->sumarPuntosAlJugador(m,otroJuego.puntajeDe(original));
 			aux=aux->siguiente;
 			if(otroJuego.jMazoRojo==original){
 				this->jMazoRojo=aux;
@@ -245,17 +1455,48 @@ CartasEnlazadas<T>::CartasEnlazadas(const CartasEnlazadas<T>& otroJuego){
 		}
 		this->adelantarMazoAzul(1);
 	}
+	// los cursores quedan en los mismos jugadores
+	this->cursores=otroJuego.cursores;
+	this->cursoresLibres=otroJuego.cursoresLibres;
+	this->nombresDeCursores=otroJuego.nombresDeCursores;
+	if(!this->cursores.empty()){
+		resolverMazos();
+		Nodo* original=otroJuego.jMazoAzul;
+		Nodo* copia=this->jMazoAzul;
+		for(Nat k=0;k<this->len;k++){
+			for(Nat c=otroJuego.leerPrimerCursor(original);c!=SIN_CURSOR;c=otroJuego.cursores[c].siguiente){
+				engancharCursor(c,copia);
+			}
+			original=original->siguiente;
+			copia=copia->siguiente;
+		}
+		for(Nat c=otroJuego.cursoresSinJugador;c!=SIN_CURSOR;c=otroJuego.cursores[c].siguiente){
+			engancharCursor(c,NULL);
+		}
+		for(Nat c=0;c<this->cursores.size();c++){
+			this->cursores[c].pendiente=0;
+			this->cursores[c].esperando=false;
+		}
+	}
 }
 
 
-template <typename T>
-void CartasEnlazadas<T>::agregarJugador(const T& jugadorNuevo) {
-	Nodo* nuevo= new Nodo(jugadorNuevo);
+template <typename T, Nat N>
+Manija CartasEnlazadas<T, N>::agregarJugador(const T& jugadorNuevo) {
+	resolverMazos();
+	Nodo* nuevo=nuevoNodo(jugadorNuevo);
+	Manija m=registrarNodo(nuevo);
+	if(this->asientosAlDia){
+		// se sienta a continuación del mazo azul
+		this->asientos.insertar(this->len==0 ? 0 : this->asientos.posicion(this->jMazoAzul->ranura)+1,nuevo->ranura,0);
+	}
+	indexarAlta(nuevo);
 	if(this->len==0){
 		this->jMazoAzul=nuevo;
 		this->jMazoRojo=nuevo;
 		nuevo->siguiente=nuevo;
 		nuevo->anterior=nuevo;
+		mudarCursores(NULL,nuevo);
 	}else{
 		nuevo->siguiente=this->jMazoAzul->siguiente;
 		nuevo->anterior=jMazoAzul;
@@ -263,15 +1504,19 @@ void CartasEnlazadas<T>::agregarJugador(const T& jugadorNuevo) {
 		this->jMazoAzul->siguiente=nuevo;
 	}
 	this->len=this->len+1;
+	informar(CAMBIO_AGREGAR,nuevo,0);
+	compactarPaso();
+	return m;
 }
 
-template <typename T>
+template <typename T, Nat N>
 
-ostream& CartasEnlazadas<T>::mostrarCartasEnlazadas(std::ostream& os ) const {
+ostream& CartasEnlazadas<T, N>::mostrarCartasEnlazadas(std::ostream& os ) const {
+	resolverMazos();
 	os<<"[";
 	Nodo* n = this->jMazoAzul;
 	if(n!=NULL){
-		os<<"("<<n->jugador<<","<<n->puntaje<<")";
+		os<<"("<<n->jugador<<","<<puntajeDe(n)<<")";
 		if(this->jMazoRojo->jugador==n->jugador){
 			os<<"*";
 			}
@@ -280,7 +1525,7 @@ ostream& CartasEnlazadas<T>::mostrarCartasEnlazadas(std::ostream& os ) const {
 			os<<",";
 		}
 		while (n != jMazoAzul) {
-			os<<"("<<n->jugador<<","<<n->puntaje<<")";
+			os<<"("<<n->jugador<<","<<puntajeDe(n)<<")";
 			if(this->jMazoRojo->jugador==n->jugador){
 			os<<"*";
 			}
@@ -289,183 +1534,1208 @@ ostream& CartasEnlazadas<T>::mostrarCartasEnlazadas(std::ostream& os ) const {
 		}
 	}
 	os<<"]";
+	return os;
 	}
 
-template <typename T>
-void CartasEnlazadas<T>::adelantarMazoRojo(int n){
-	int i=n;
-	if(i>0){
-		while(i>0){
-	 		this->jMazoRojo=this->jMazoRojo->siguiente;
-	 		i--;
-	 	}
-	}else{
-		while(i<0){
-			this->jMazoRojo=this->jMazoRojo->anterior;
-			i++;
+template <typename T, Nat N>
+void CartasEnlazadas<T, N>::adelantarMazoRojo(int n){
+	assert(this->len>0);
+	this->pendienteRojo=(this->pendienteRojo + n % (long)this->len) % (long)this->len;
+	informar(CAMBIO_MAZO_ROJO,n);
+}
+
+template <typename T, Nat N>
+void CartasEnlazadas<T, N>::adelantarMazoAzul(int n){
+	assert(this->len>0);
+	this->pendienteAzul=(this->pendienteAzul + n % (long)this->len) % (long)this->len;
+	informar(CAMBIO_MAZO_AZUL,n);
+}
+
+template <typename T, Nat N>
+void CartasEnlazadas<T, N>::resolverMazos() const{
+	if(this->pendienteRojo!=0){
+		this->jMazoRojo=avanzar(this->jMazoRojo,this->pendienteRojo);
+		this->pendienteRojo=0;
+	}
+	if(this->pendienteAzul!=0){
+		this->jMazoAzul=avanzar(this->jMazoAzul,this->pendienteAzul);
+		this->pendienteAzul=0;
+	}
+	// sin cursores pendientes no se escribe nada: los lectores de una versión
+	// publicada llaman a esto desde varios hilos
+	if(!this->cursoresPendientes.empty()){
+		for(Nat i=0;i<this->cursoresPendientes.size();i++){
+			Nat c=this->cursoresPendientes[i];
+			this->cursores[c].esperando=false;
+			resolverCursor(c);
 		}
+		this->cursoresPendientes.clear();
 	}
 }
 
-template <typename T>
-void CartasEnlazadas<T>::adelantarMazoAzul(int n){
-	int i=n;
-	if(i>0){
+template <typename T, Nat N>
+typename CartasEnlazadas<T, N>::Nodo* CartasEnlazadas<T, N>::avanzar(Nodo* desde, long n) const{
+	long l=this->len;
+	long i=((n % l) + l) % l;
+	Nodo* res=desde;
+	if(i<=l/2){
 		while(i>0){
-	 		this->jMazoAzul=this->jMazoAzul->siguiente;
-	 		i--;
-	 	}
+			res=res->siguiente;
+			i--;
+		}
 	}else{
-		while(i<0){
-			this->jMazoAzul=this->jMazoAzul->anterior;
-			i++;
+		i=l-i;
+		while(i>0){
+			res=res->anterior;
+			i--;
 		}
 	}
+	return res;
 }
 
-template<typename T>
-const T& CartasEnlazadas<T>::dameJugadorConMazoRojo() const{
-	return this->jMazoRojo->jugador;
+template <typename T, Nat N>
+Nat CartasEnlazadas<T, N>::crearCursor(const string& nombre){
+	assert(!existeCursor(nombre));
+	resolverMazos();
+	Nat c;
+	if(this->cursoresLibres.empty()){
+		c=this->cursores.size();
+		this->cursores.push_back(DatosCursor());
+	}else{
+		c=this->cursoresLibres.back();
+		this->cursoresLibres.pop_back();
+	}
+	DatosCursor& d=this->cursores[c];
+	d.nombre=nombre;
+	d.pendiente=0;
+	d.enUso=true;
+	d.esperando=false;
+	engancharCursor(c,this->jMazoAzul);
+	this->nombresDeCursores[nombre]=c;
+	return c;
 }
 
-template<typename T>
-const T& CartasEnlazadas<T>::dameJugadorConMazoAzul() const{
-	return this->jMazoAzul->jugador;
+template <typename T, Nat N>
+void CartasEnlazadas<T, N>::eliminarCursor(Nat c){
+	assert(c<this->cursores.size() && this->cursores[c].enUso);
+	desengancharCursor(c);
+	DatosCursor& d=this->cursores[c];
+	this->nombresDeCursores.erase(d.nombre);
+	d.nodo=NULL;
+	d.pendiente=0;
+	d.enUso=false;
+	this->cursoresLibres.push_back(c);
 }
 
+template <typename T, Nat N>
+Nat CartasEnlazadas<T, N>::cursor(const string& nombre) const{
+	typename map<string, Nat>::const_iterator it=this->nombresDeCursores.find(nombre);
+	assert(it!=this->nombresDeCursores.end());
+	return it->second;
+}
 
-template<typename T>
-const T& CartasEnlazadas<T>::dameJugador(int n) const{
-	int i=n;
-	Nodo* nuevo= this->jMazoRojo;
-	if(i>0){
-		while(i>0){
-	 		nuevo=nuevo->siguiente;
-	 		i--;
-	 	}
-	}else{
-		while(i<0){
-			nuevo=nuevo->anterior;
-			i++;
-		}
-	}
-	return nuevo->jugador;
+template <typename T, Nat N>
+bool CartasEnlazadas<T, N>::existeCursor(const string& nombre) const{
+	return this->nombresDeCursores.count(nombre)>0;
 }
 
-template<typename T>
-const T& CartasEnlazadas<T>::dameJugadorEnfrentado() const{
-	int i=this->len/2;
-	return (dameJugador(i));
+template <typename T, Nat N>
+Nat CartasEnlazadas<T, N>::cantidadDeCursores() const{
+	return this->nombresDeCursores.size();
+}
 
+template <typename T, Nat N>
+const string& CartasEnlazadas<T, N>::nombreDelCursor(Nat c) const{
+	assert(c<this->cursores.size() && this->cursores[c].enUso);
+	return this->cursores[c].nombre;
 }
 
-template<typename T>
-void CartasEnlazadas<T>::eliminarJugador(const T& target){
-	int i=this->len;
-	Nodo* nuevo=this->jMazoAzul;
-	Nodo* nuevo2=nuevo->siguiente;
-	while(nuevo->jugador!=target){
-		nuevo=nuevo->siguiente;
-		nuevo2=nuevo->siguiente;
-	}
-	if(this->jMazoRojo==nuevo){
-		this->jMazoRojo=nuevo2;
-	}
-	if(this->jMazoAzul==nuevo){
-		this->jMazoAzul=nuevo2;
-	}
-	if(this->len==1){
-		this->jMazoAzul=NULL;
-		this->jMazoRojo=NULL;
+template <typename T, Nat N>
+void CartasEnlazadas<T, N>::moverCursor(Nat c, int n){
+	assert(this->len>0);
+	assert(c<this->cursores.size() && this->cursores[c].enUso);
+	DatosCursor& d=this->cursores[c];
+	d.pendiente=(d.pendiente + n % (long)this->len) % (long)this->len;
+	if(!d.esperando){
+		d.esperando=true;
+		this->cursoresPendientes.push_back(c);
 	}
-	nuevo->anterior->siguiente=nuevo->siguiente;
-	nuevo->siguiente->anterior=nuevo->anterior;
-	nuevo->siguiente=NULL;
-	nuevo->anterior=NULL;
-	this->len=this->len -1;
-	delete nuevo;
+}
 
+template <typename T, Nat N>
+void CartasEnlazadas<T, N>::ponerCursor(Nat c, const T& jugador){
+	Nodo* nodo=buscar(jugador);
+	assert(nodo!=NULL);
+	assert(c<this->cursores.size() && this->cursores[c].enUso);
+	desengancharCursor(c);
+	engancharCursor(c,nodo);
+	this->cursores[c].pendiente=0;
 }
 
-template<typename T>
-void CartasEnlazadas<T>::eliminarJugadorConMazoAzul(){
-	eliminarJugador(dameJugadorConMazoAzul());
+template <typename T, Nat N>
+void CartasEnlazadas<T, N>::ponerCursor(Nat c, const Manija& m){
+	Nodo* nodo=this->manijas.resolver(m);
+	assert(nodo!=NULL);
+	assert(c<this->cursores.size() && this->cursores[c].enUso);
+	desengancharCursor(c);
+	engancharCursor(c,nodo);
+	this->cursores[c].pendiente=0;
 }
 
-template<typename T>
-bool CartasEnlazadas<T>::existeJugador(const T& target) const{
-	bool res=false;
-	int i=this->len;
-	Nodo* nuevo=this->jMazoAzul;
-	while(i>0){
-		if(nuevo->jugador==target){
-			res=res || true;
-		}else{
-			res= res || false;
-	   	}
-	   	nuevo=nuevo->siguiente;
-	   	i--;
+template <typename T, Nat N>
+const T& CartasEnlazadas<T, N>::jugadorConCursor(Nat c) const{
+	assert(this->len>0);
+	assert(c<this->cursores.size() && this->cursores[c].enUso);
+	resolverCursor(c);
+	return this->cursores[c].nodo->jugador;
+}
+
+template <typename T, Nat N>
+vector<Nat> CartasEnlazadas<T, N>::cursoresDelJugador(const T& jugador) const{
+	// un cursor que todavía no se movió puede caer en este jugador
+	resolverMazos();
+	Nodo* nodo=buscar(jugador);
+	assert(nodo!=NULL);
+	vector<Nat> res;
+	for(Nat c=leerPrimerCursor(nodo);c!=SIN_CURSOR;c=this->cursores[c].siguiente){
+		res.push_back(c);
 	}
 	return res;
 }
 
-template<typename T>
-void CartasEnlazadas<T>::sumarPuntosAlJugador(const T& target, int p){
+template <typename T, Nat N>
+Nat& CartasEnlazadas<T, N>::primerCursorDe(Nodo* nodo) const{
+	if(nodo==NULL){
+		return this->cursoresSinJugador;
+	}
+	if(nodo->ranura>=this->primerosCursores.size()){
+		this->primerosCursores.resize(nodo->ranura+1,Nat(SIN_CURSOR));
+	}
+	return this->primerosCursores[nodo->ranura];
+}
+
+template <typename T, Nat N>
+Nat CartasEnlazadas<T, N>::leerPrimerCursor(const Nodo* nodo) const{
+	if(nodo==NULL){
+		return this->cursoresSinJugador;
+	}
+	if(nodo->ranura>=this->primerosCursores.size()){
+		return SIN_CURSOR;
+	}
+	return this->primerosCursores[nodo->ranura];
+}
+
+template <typename T, Nat N>
+Manija CartasEnlazadas<T, N>::registrarNodo(Nodo* nodo){
+	Manija m=this->manijas.registrar(nodo);
+	assert(m.ranura<(1u<<30));
+	nodo->ranura=m.ranura;
+	// al liberarse la ranura sus cursores ya habían pasado a otro jugador
+	assert(leerPrimerCursor(nodo)==SIN_CURSOR);
+	return m;
+}
+
+template <typename T, Nat N>
+void CartasEnlazadas<T, N>::engancharCursor(Nat c, Nodo* nodo) const{
+	Nat& primero=primerCursorDe(nodo);
+	DatosCursor& d=this->cursores[c];
+	d.nodo=nodo;
+	d.anterior=SIN_CURSOR;
+	d.siguiente=primero;
+	if(primero!=SIN_CURSOR){
+		this->cursores[primero].anterior=c;
+	}
+	primero=c;
+}
+
+template <typename T, Nat N>
+void CartasEnlazadas<T, N>::desengancharCursor(Nat c) const{
+	DatosCursor& d=this->cursores[c];
+	if(d.anterior!=SIN_CURSOR){
+		this->cursores[d.anterior].siguiente=d.siguiente;
+	}else{
+		primerCursorDe(d.nodo)=d.siguiente;
+	}
+	if(d.siguiente!=SIN_CURSOR){
+		this->cursores[d.siguiente].anterior=d.anterior;
+	}
+}
+
+template <typename T, Nat N>
+void CartasEnlazadas<T, N>::resolverCursor(Nat c) const{
+	DatosCursor& d=this->cursores[c];
+	if(d.pendiente!=0){
+		Nodo* destino=avanzar(d.nodo,d.pendiente);
+		desengancharCursor(c);
+		engancharCursor(c,destino);
+		d.pendiente=0;
+	}
+}
+
+template <typename T, Nat N>
+void CartasEnlazadas<T, N>::mudarCursores(Nodo* desde, Nodo* hacia){
+	if(this->cursores.empty() || desde==hacia){
+		return;
+	}
+	Nat c=primerCursorDe(desde);
+	while(c!=SIN_CURSOR){
+		Nat sig=this->cursores[c].siguiente;
+		engancharCursor(c,hacia);
+		if(hacia==NULL){
+			// en una mesa vacía no hay lugares para avanzar
+			this->cursores[c].pendiente=0;
+		}
+		c=sig;
+	}
+	primerCursorDe(desde)=SIN_CURSOR;
+}
+
+template <typename T, Nat N>
+const T& CartasEnlazadas<T, N>::dameJugadorConMazoRojo() const{
+	resolverMazos();
+	return this->jMazoRojo->jugador;
+}
+
+template <typename T, Nat N>
+const T& CartasEnlazadas<T, N>::dameJugadorConMazoAzul() const{
+	resolverMazos();
+	return this->jMazoAzul->jugador;
+}
+
+
+template <typename T, Nat N>
+const T& CartasEnlazadas<T, N>::dameJugador(int n) const{
+	resolverMazos();
+	return avanzar(this->jMazoRojo,n)->jugador;
+}
+
+template <typename T, Nat N>
+const T& CartasEnlazadas<T, N>::dameJugadorEnfrentado() const{
+	int i=this->len/2;
+	return (dameJugador(i));
+
+}
+
+template <typename T, Nat N>
+void CartasEnlazadas<T, N>::eliminarJugador(const T& target){
+	resolverMazos();
+	Nodo* nuevo=buscar(target);
+	if(nuevo!=NULL){
+		informar(CAMBIO_ELIMINAR,nuevo,0);
+		quitarNodo(nuevo);
+		compactarPaso();
+	}
+}
+
+template <typename T, Nat N>
+template <typename K>
+typename CartasEnlazadas<T, N>::Nodo* CartasEnlazadas<T, N>::buscar(const K& target) const{
 	Nodo* nuevo=this->jMazoAzul;
-	int i=this->len;
+	Nat i=this->len;
 	while(i>0){
 		if(nuevo->jugador==target){
-			nuevo->puntaje=nuevo->puntaje+p;
+			return nuevo;
 		}
-		i--;
 		nuevo=nuevo->siguiente;
+		i--;
 	}
+	return NULL;
+}
 
+template <typename T, Nat N>
+void CartasEnlazadas<T, N>::quitarNodo(Nodo* nuevo){
+	this->manijas.liberar(nuevo->ranura);
+	desenlazar(nuevo);
+	liberarNodo(nuevo);
 }
 
-template<typename T>
-int CartasEnlazadas<T>::puntosDelJugador(const T& target) const{
-	Nodo* nuevo=this->jMazoAzul;
-	int res;
-	int i=this->len;
+template <typename T, Nat N>
+typename CartasEnlazadas<T, N>::Nodo* CartasEnlazadas<T, N>::nuevoNodo(const T& jugador){
+	if(this->borradoDiferido){
+		return this->arena.crear(jugador);
+	}
+	return this->almacen.crear(jugador);
+}
+
+template <typename T, Nat N>
+void CartasEnlazadas<T, N>::liberarNodo(Nodo* nodo){
+	if(!this->arena.esPropio(nodo)){
+		this->almacen.destruir(nodo);
+		return;
+	}
+	this->arena.destruir(nodo);
+	if(this->borradoDiferido && this->compactando==NULL && this->len>0 && this->arena.lapidas()>max<size_t>(16,this->arena.vivos())){
+		this->arena.nuevaGeneracion();
+		this->compactando=this->jMazoAzul;
+	}
+}
+
+template <typename T, Nat N>
+void CartasEnlazadas<T, N>::compactarPaso(){
+	for(int i=0;i<4 && this->compactando!=NULL;i++){
+		Nodo* nodo=this->compactando;
+		this->compactando=nodo->siguiente;
+		if(!this->arena.esNuevo(nodo)){
+			reubicar(nodo);
+		}
+		if(this->len==this->arena.vivos()){
+			this->compactando=NULL;
+		}
+	}
+}
+
+template <typename T, Nat N>
+void CartasEnlazadas<T, N>::reubicar(Nodo* nodo){
+	Nodo* nuevo=this->arena.crear(nodo->jugador);
+	nuevo->puntaje=nodo->puntaje;
+	nuevo->ranura=nodo->ranura;
+	nuevo->marca=nodo->marca;
+	// la ranura no cambia, así que la lista de cursores tampoco
+	for(Nat c=leerPrimerCursor(nuevo);c!=SIN_CURSOR;c=this->cursores[c].siguiente){
+		this->cursores[c].nodo=nuevo;
+	}
+	if(nodo->siguiente==nodo){
+		nuevo->siguiente=nuevo;
+		nuevo->anterior=nuevo;
+	}else{
+		nuevo->siguiente=nodo->siguiente;
+		nuevo->anterior=nodo->anterior;
+		nodo->anterior->siguiente=nuevo;
+		nodo->siguiente->anterior=nuevo;
+	}
+	this->manijas.reubicar(nuevo->ranura,nuevo);
+	if(this->jMazoAzul==nodo){
+		this->jMazoAzul=nuevo;
+	}
+	if(this->jMazoRojo==nodo){
+		this->jMazoRojo=nuevo;
+	}
+	if(this->compactando==nodo){
+		this->compactando=nuevo;
+	}
+	liberarNodo(nodo);
+}
+
+template <typename T, Nat N>
+void CartasEnlazadas<T, N>::desenlazar(Nodo* nuevo){
+	indexarBaja(nuevo);
+	if(this->asientosAlDia){
+		nuevo->puntaje=this->asientos.valor(nuevo->ranura);
+		this->asientos.quitar(nuevo->ranura);
+	}
+	Nodo* nuevo2=nuevo->siguiente;
+	if(this->compactando==nuevo){
+		this->compactando=this->len==1 ? NULL : nuevo2;
+	}
+	if(this->jMazoRojo==nuevo){
+		this->jMazoRojo=nuevo2;
+	}
+	if(this->jMazoAzul==nuevo){
+		this->jMazoAzul=nuevo2;
+	}
+	if(this->len==1){
+		this->jMazoAzul=NULL;
+		this->jMazoRojo=NULL;
+	}
+	mudarCursores(nuevo,this->len==1 ? NULL : nuevo2);
+	nuevo->anterior->siguiente=nuevo->siguiente;
+	nuevo->siguiente->anterior=nuevo->anterior;
+	nuevo->siguiente=NULL;
+	nuevo->anterior=NULL;
+	this->len=this->len -1;
+}
+
+template <typename T, Nat N>
+void CartasEnlazadas<T, N>::transferirJugadores(CartasEnlazadas<T, N>& origen, const T& primero, Nat cantidad){
+	origen.resolverMazos();
+	Nodo* nodo=origen.buscar(primero);
+	assert(nodo!=NULL);
+	origen.cortarArco(nodo,cantidad);
+	adoptarCadena(origen,nodo,cantidad);
+}
+
+template <typename T, Nat N>
+void CartasEnlazadas<T, N>::transferirJugadores(CartasEnlazadas<T, N>& origen, const Manija& primero, Nat cantidad){
+	origen.resolverMazos();
+	Nodo* nodo=origen.manijas.resolver(primero);
+	assert(nodo!=NULL);
+	origen.cortarArco(nodo,cantidad);
+	adoptarCadena(origen,nodo,cantidad);
+}
+
+template <typename T, Nat N>
+void CartasEnlazadas<T, N>::unir(CartasEnlazadas<T, N>& otra){
+	if(otra.len>0){
+		otra.resolverMazos();
+		Nat cantidad=otra.len;
+		Nodo* primero=otra.jMazoAzul;
+		otra.cortarArco(primero,cantidad);
+		adoptarCadena(otra,primero,cantidad);
+	}
+}
+
+template <typename T, Nat N>
+template <typename Predicado>
+void CartasEnlazadas<T, N>::separar(CartasEnlazadas<T, N>& destino, Predicado cumple){
+	assert(&destino!=this);
+	resolverMazos();
+	Nodo* primero=NULL;
+	Nodo* ultimo=NULL;
+	Nat cantidad=0;
+	Nodo* nodo=this->jMazoAzul;
+	Nat i=this->len;
 	while(i>0){
-		if(nuevo->jugador==target){
-			res=nuevo->puntaje;
+		Nodo* sig=nodo->siguiente;
+		if(cumple(nodo->jugador)){
+			desenlazar(nodo);
+			if(primero==NULL){
+				primero=nodo;
+			}else{
+				ultimo->siguiente=nodo;
+			}
+			ultimo=nodo;
+			cantidad++;
 		}
+		nodo=sig;
 		i--;
-		nuevo=nuevo->siguiente;
 	}
-	return res;
+	if(cantidad>0){
+		informar(CAMBIO_RESINCRONIZAR,0);
+		destino.adoptarCadena(*this,primero,cantidad);
+	}
 }
 
-template<typename T>
-const T& CartasEnlazadas<T>::ganador() const{
-	Nodo* maximo=this->jMazoAzul;
-	Nodo* otro=maximo->siguiente;
+template <typename T, Nat N>
+void CartasEnlazadas<T, N>::cortarArco(Nodo* primero, Nat cantidad){
+	assert(cantidad>0 && cantidad<=this->len);
+	bool rojo=false;
+	bool azul=false;
+	bool mudando=false;
+	Nodo* ultimo=primero;
+	for(Nat i=1;i<=cantidad;i++){
+		rojo=rojo || ultimo==this->jMazoRojo;
+		azul=azul || ultimo==this->jMazoAzul;
+		mudando=mudando || ultimo==this->compactando;
+		indexarBaja(ultimo);
+		if(this->asientosAlDia){
+			ultimo->puntaje=this->asientos.valor(ultimo->ranura);
+			this->asientos.quitar(ultimo->ranura);
+		}
+		if(i<cantidad){
+			ultimo=ultimo->siguiente;
+		}
+	}
+	if(!this->cursores.empty()){
+		// los cursores del arco pasan al que sigue, como los mazos
+		Nodo* hacia=cantidad==this->len ? NULL : ultimo->siguiente;
+		Nodo* nodo=primero;
+		for(Nat i=0;i<cantidad;i++){
+			mudarCursores(nodo,hacia);
+			nodo=nodo->siguiente;
+		}
+	}
+	if(cantidad==this->len){
+		this->jMazoAzul=NULL;
+		this->jMazoRojo=NULL;
+		this->compactando=NULL;
+	}else{
+		Nodo* antes=primero->anterior;
+		Nodo* despues=ultimo->siguiente;
+		antes->siguiente=despues;
+		despues->anterior=antes;
+		if(rojo){
+			this->jMazoRojo=despues;
+		}
+		if(azul){
+			this->jMazoAzul=despues;
+		}
+		if(mudando){
+			this->compactando=despues;
+		}
+	}
+	this->len=this->len-cantidad;
+	informar(CAMBIO_RESINCRONIZAR,0);
+}
+
+template <typename T, Nat N>
+void CartasEnlazadas<T, N>::adoptarCadena(CartasEnlazadas<T, N>& origen, Nodo* primero, Nat cantidad){
+	assert(&origen!=this);
+	resolverMazos();
+	Nodo* cabeza=NULL;
+	Nodo* cola=NULL;
+	Nodo* nodo=primero;
+	// posición en el árbol de asientos del primero que se sienta
+	Nat lugar=0;
+	if(this->asientosAlDia && this->len>0){
+		lugar=this->asientos.posicion(this->jMazoAzul->ranura)+1;
+	}
+	for(Nat i=0;i<cantidad;i++){
+		Nodo* sig=nodo->siguiente;
+		origen.manijas.liberar(nodo->ranura);
+		Nodo* movido=nodo;
+		if(origen.almacen.esPropio(nodo) || origen.arena.esPropio(nodo)){
+			// vive dentro del objeto origen o de su arena: hay que copiarlo
+			movido=nuevoNodo(nodo->jugador);
+			movido->puntaje=nodo->puntaje;
+			origen.liberarNodo(nodo);
+		}
+		// sus cursores ya pasaron al que lo seguía en origen
+		registrarNodo(movido);
+		// lo que se anotó para mostrarCambios queda en origen
+		movido->marca=LIMPIO;
+		if(this->asientosAlDia){
+			this->asientos.insertar(lugar+i,movido->ranura,movido->puntaje);
+		}
+		indexarAlta(movido);
+		if(cabeza==NULL){
+			cabeza=movido;
+		}else{
+			cola->siguiente=movido;
+			movido->anterior=cola;
+		}
+		cola=movido;
+		nodo=sig;
+	}
+	if(this->len==0){
+		cabeza->anterior=cola;
+		cola->siguiente=cabeza;
+		this->jMazoAzul=cabeza;
+		this->jMazoRojo=cabeza;
+		mudarCursores(NULL,cabeza);
+	}else{
+		cola->siguiente=this->jMazoAzul->siguiente;
+		this->jMazoAzul->siguiente->anterior=cola;
+		this->jMazoAzul->siguiente=cabeza;
+		cabeza->anterior=this->jMazoAzul;
+	}
+	this->len=this->len+cantidad;
+	informar(CAMBIO_RESINCRONIZAR,0);
+}
+
+template <typename T, Nat N>
+void CartasEnlazadas<T, N>::eliminarJugadorConMazoAzul(){
+	eliminarJugador(dameJugadorConMazoAzul());
+}
+
+template <typename T, Nat N>
+vector<T> CartasEnlazadas<T, N>::eliminarCadaK(int k, Nat cantidad){
+	assert(cantidad<=this->len);
+	resolverMazos();
+	vector<T> orden;
+	orden.reserve(cantidad);
+	if(cantidad==0){
+		return orden;
+	}
+	// asientos[i] es el jugador sentado i lugares después del mazo azul
+	vector<Nodo*> asientos;
+	asientos.reserve(this->len);
+	Nodo* n=this->jMazoAzul;
+	for(Nat i=0;i<this->len;i++){
+		asientos.push_back(n);
+		n=n->siguiente;
+	}
+	ArbolFenwick enPie(this->len);
+	// posición del mazo azul entre los jugadores que siguen en pie
+	long azul=0;
+	while(cantidad>0){
+		long quedan=this->len;
+		azul=((azul + k % quedan) % quedan + quedan) % quedan;
+		Nat asiento=enPie.buscar(azul);
+		enPie.sumar(asiento,-1);
+		orden.push_back(asientos[asiento]->jugador);
+		this->jMazoAzul=asientos[asiento];
+		quitarNodo(asientos[asiento]);
+		if(this->len>0){
+			azul=azul % (long)this->len;
+		}
+		cantidad--;
+	}
+	informar(CAMBIO_RESINCRONIZAR,0);
+	return orden;
+}
+
+template <typename T, Nat N>
+bool CartasEnlazadas<T, N>::existeJugador(const T& target) const{
+	bool res=false;
 	int i=this->len;
+	Nodo* nuevo=this->jMazoAzul;
 	while(i>0){
-		if(maximo->puntaje < otro->puntaje){
-			maximo=otro;
+		if(nuevo->jugador==target){
+			res=res || true;
+		}else{
+			res= res || false;
+	   	}
+	   	nuevo=nuevo->siguiente;
+	   	i--;
+	}
+	return res;
+}
+
+template <typename T, Nat N>
+void CartasEnlazadas<T, N>::sumarPuntosAlJugador(const T& target, int p){
+	Nodo* nodo=buscar(target);
+	assert(nodo!=NULL);
+	sumarPuntos(nodo,p);
+}
+
+template <typename T, Nat N>
+template <typename Iterador>
+void CartasEnlazadas<T, N>::sumarPuntosEnLote(Iterador desde, Iterador hasta){
+	Nodo* nodo=this->jMazoAzul;
+	for(;desde!=hasta;++desde){
+		// se busca a partir del último encontrado
+		Nat i=this->len;
+		while(i>0 && !(nodo->jugador==desde->first)){
+			nodo=nodo->siguiente;
+			i--;
+		}
+		assert(i>0);
+		if(desde->second!=0){
+			sumarPuntos(nodo,desde->second);
 		}
-		otro=otro->siguiente;
-		i--;
 	}
-	return maximo->jugador;
+}
+
+template <typename T, Nat N>
+void CartasEnlazadas<T, N>::sumarPuntosPorAsiento(const vector<int>& puntos){
+	assert(puntos.size()<=this->len);
+	resolverMazos();
+	Nodo* nodo=this->jMazoAzul;
+	for(Nat i=0;i<puntos.size();i++){
+		if(puntos[i]!=0){
+			sumarPuntos(nodo,puntos[i]);
+		}
+		nodo=nodo->siguiente;
+	}
+}
+
+template <typename T, Nat N>
+void CartasEnlazadas<T, N>::sumarPuntos(Nodo* nodo, int p){
+	indexarBaja(nodo);
+	if(this->asientosAlDia){
+		this->asientos.sumarValor(nodo->ranura,p);
+	}else{
+		nodo->puntaje=nodo->puntaje+p;
+	}
+	indexarAlta(nodo);
+	informar(CAMBIO_PUNTOS,nodo,p);
+}
+
+template <typename T, Nat N>
+void CartasEnlazadas<T, N>::informar(TipoDeCambio tipo, long valor){
+	if(tipo==CAMBIO_RESINCRONIZAR){
+		if(this->canal!=NULL){
+			this->fotoPendiente=true;
+			// si la foto no entra, al menos se marca dónde dejó de valer la copia
+			if(!actualizarCanal()){
+				this->canal->emitir(Cambio<T>(CAMBIO_RESINCRONIZAR,0));
+			}
+		}
+		desbordar();
+	}else{
+		emitir(Cambio<T>(tipo,valor),true);
+	}
+}
+
+template <typename T, Nat N>
+void CartasEnlazadas<T, N>::informar(TipoDeCambio tipo, Nodo* nodo, long valor){
+	// eliminar se informa antes de sacar el nodo
+	emitir(Cambio<T>(tipo,nodo->jugador,valor),tipo!=CAMBIO_ELIMINAR);
+	if(tipo==CAMBIO_AGREGAR){
+		marcar(nodo,NUEVO);
+	}else if(tipo==CAMBIO_PUNTOS){
+		marcar(nodo,CAMBIADO);
+	}else if(tipo==CAMBIO_ELIMINAR && this->siguiendo && !this->desbordado && nodo->marca!=NUEVO){
+		// si se sentó después del último mostrarCambios no hay nada que sacar
+		this->quitados.push_back(nodo->jugador);
+	}
+}
+
+template <typename T, Nat N>
+void CartasEnlazadas<T, N>::marcar(Nodo* nodo, Marca m){
+	if(!this->siguiendo || this->desbordado || nodo->marca!=LIMPIO){
+		return;
+	}
+	nodo->marca=m;
+	this->sucios.push_back(this->manijas.manija(nodo->ranura));
+	// las manijas de los que salieron también quedan en la lista
+	if(this->sucios.size()>2*(size_t)this->len+16){
+		desbordar();
+	}
+}
+
+template <typename T, Nat N>
+void CartasEnlazadas<T, N>::desbordar(){
+	if(!this->siguiendo){
+		return;
+	}
+	for(Nat i=0;i<this->sucios.size();i++){
+		Nodo* nodo=this->manijas.resolver(this->sucios[i]);
+		if(nodo!=NULL){
+			nodo->marca=LIMPIO;
+		}
+	}
+	this->sucios.clear();
+	this->quitados.clear();
+	this->desbordado=true;
+}
+
+template <typename T, Nat N>
+void CartasEnlazadas<T, N>::seguirCambios(bool s){
+	desbordar();
+	this->siguiendo=s;
+	this->desbordado=s;
+	this->rojoMostrado=MANIJA_INVALIDA;
+	this->azulMostrado=MANIJA_INVALIDA;
+}
+
+template <typename T, Nat N>
+bool CartasEnlazadas<T, N>::sigueCambios() const{
+	return this->siguiendo;
+}
+
+template <typename T, Nat N>
+ostream& CartasEnlazadas<T, N>::mostrarCambios(ostream& os){
+	assert(this->siguiendo);
+	resolverMazos();
+	Manija rojo=MANIJA_INVALIDA;
+	Manija azul=MANIJA_INVALIDA;
+	if(this->len>0){
+		rojo=this->manijas.manija(this->jMazoRojo->ranura);
+		azul=this->manijas.manija(this->jMazoAzul->ranura);
+	}
+	if(this->desbordado){
+		os<<"!"<<'\n';
+		this->desbordado=false;
+	}else{
+		for(Nat i=0;i<this->quitados.size();i++){
+			os<<"- "<<this->quitados[i]<<'\n';
+		}
+		for(Nat i=0;i<this->sucios.size();i++){
+			Nodo* nodo=this->manijas.resolver(this->sucios[i]);
+			// se saltean los que salieron y los que ya se mostraron
+			if(nodo!=NULL && nodo->marca!=LIMPIO){
+				os<<(nodo->marca==NUEVO ? "+ " : "~ ");
+				mostrarJugador(os,nodo);
+				os<<'\n';
+				nodo->marca=LIMPIO;
+			}
+		}
+		if(rojo!=this->rojoMostrado){
+			os<<"R ";
+			if(rojo==MANIJA_INVALIDA){
+				os<<"-";
+			}else{
+				os<<this->jMazoRojo->jugador;
+			}
+			os<<'\n';
+		}
+		if(azul!=this->azulMostrado){
+			os<<"A ";
+			if(azul==MANIJA_INVALIDA){
+				os<<"-";
+			}else{
+				os<<this->jMazoAzul->jugador;
+			}
+			os<<'\n';
+		}
+	}
+	this->sucios.clear();
+	this->quitados.clear();
+	this->rojoMostrado=rojo;
+	this->azulMostrado=azul;
+	return os;
+}
+
+template <typename T, Nat N>
+Manija CartasEnlazadas<T, N>::mostrarPagina(ostream& os, const Manija& desde, Nat cantidad) const{
+	assert(cantidad>0);
+	resolverMazos();
+	Manija siguiente=MANIJA_INVALIDA;
+	os<<"[";
+	if(this->len>0){
+		Nodo* nodo=this->jMazoAzul;
+		if(desde!=MANIJA_INVALIDA){
+			nodo=this->manijas.resolver(desde);
+			assert(nodo!=NULL);
+		}
+		Nat i=0;
+		do{
+			if(i!=0){
+				os<<",";
+			}
+			mostrarJugador(os,nodo);
+			if(nodo==this->jMazoRojo){
+				os<<"*";
+			}
+			nodo=nodo->siguiente;
+			i++;
+		}while(i<cantidad && nodo!=this->jMazoAzul);
+		if(nodo!=this->jMazoAzul){
+			siguiente=this->manijas.manija(nodo->ranura);
+		}
+	}
+	os<<"]";
+	return siguiente;
+}
+
+template <typename T, Nat N>
+void CartasEnlazadas<T, N>::mostrarJugador(ostream& os, const Nodo* nodo) const{
+	os<<"("<<nodo->jugador<<","<<puntajeDe(nodo)<<")";
+}
+
+template <typename T, Nat N>
+int CartasEnlazadas<T, N>::puntajeDe(const Nodo* nodo) const{
+	if(this->asientosAlDia){
+		return this->asientos.valor(nodo->ranura);
+	}
+	return nodo->puntaje;
+}
+
+template <typename T, Nat N>
+void CartasEnlazadas<T, N>::armarAsientos() const{
+	if(!this->asientosAlDia){
+		this->asientos.vaciar();
+		Nodo* nodo=this->jMazoAzul;
+		for(Nat i=0;i<this->len;i++){
+			this->asientos.insertar(i,nodo->ranura,nodo->puntaje);
+			nodo=nodo->siguiente;
+		}
+		this->asientosAlDia=true;
+	}
+}
+
+template <typename T, Nat N>
+Nat CartasEnlazadas<T, N>::posicionEnRonda(const Nodo* nodo, long desde) const{
+	long l=this->len;
+	long p=(long)this->asientos.posicion(nodo->ranura) + desde % l;
+	return ((p % l) + l) % l;
+}
+
+template <typename T, Nat N>
+long CartasEnlazadas<T, N>::sumaDeArco(Nat inicio, Nat cantidad) const{
+	assert(cantidad<=this->len);
+	if(inicio+cantidad<=this->len){
+		return this->asientos.suma(inicio,cantidad);
+	}
+	Nat resto=inicio+cantidad-this->len;
+	return this->asientos.suma(inicio,this->len-inicio) + this->asientos.suma(0,resto);
+}
+
+template <typename T, Nat N>
+void CartasEnlazadas<T, N>::sumarArco(Nat inicio, Nat cantidad, int p){
+	assert(cantidad<=this->len);
+	// con un arco corto conviene corregir el índice jugador por jugador; con
+	// uno largo, armarlo de nuevo cuando se lo consulte
+	bool corregir=this->indiceAlDia && cantidad>0 && 4*cantidad<=this->len;
+	Nodo* primero=NULL;
+	if(corregir){
+		primero=this->manijas.nodoEn(this->asientos.ranuraEn(inicio));
+		Nodo* nodo=primero;
+		for(Nat i=0;i<cantidad;i++){
+			this->indice.quitar(nodo->ranura);
+			nodo=nodo->siguiente;
+		}
+	}
+	if(inicio+cantidad<=this->len){
+		this->asientos.sumar(inicio,cantidad,p);
+	}else{
+		Nat resto=inicio+cantidad-this->len;
+		this->asientos.sumar(inicio,this->len-inicio,p);
+		this->asientos.sumar(0,resto,p);
+	}
+	if(corregir){
+		Nodo* nodo=primero;
+		for(Nat i=0;i<cantidad;i++){
+			this->indice.insertar(nodo->ranura,puntajeDe(nodo));
+			nodo=nodo->siguiente;
+		}
+	}else{
+		this->indiceAlDia=false;
+	}
+	informar(CAMBIO_RESINCRONIZAR,0);
+}
+
+template <typename T, Nat N>
+long CartasEnlazadas<T, N>::puntosDelArcoDesdeMazoRojo(int desde, Nat cantidad) const{
+	assert(this->len>0);
+	armarAsientos();
+	return sumaDeArco(posicionEnRonda(this->jMazoRojo,this->pendienteRojo+desde),cantidad);
+}
+
+template <typename T, Nat N>
+long CartasEnlazadas<T, N>::puntosDelArcoDesdeMazoAzul(int desde, Nat cantidad) const{
+	assert(this->len>0);
+	armarAsientos();
+	return sumaDeArco(posicionEnRonda(this->jMazoAzul,this->pendienteAzul+desde),cantidad);
+}
+
+template <typename T, Nat N>
+void CartasEnlazadas<T, N>::sumarPuntosAlArcoDesdeMazoRojo(int desde, Nat cantidad, int p){
+	assert(this->len>0);
+	armarAsientos();
+	sumarArco(posicionEnRonda(this->jMazoRojo,this->pendienteRojo+desde),cantidad,p);
+}
 
+template <typename T, Nat N>
+void CartasEnlazadas<T, N>::sumarPuntosAlArcoDesdeMazoAzul(int desde, Nat cantidad, int p){
+	assert(this->len>0);
+	armarAsientos();
+	sumarArco(posicionEnRonda(this->jMazoAzul,this->pendienteAzul+desde),cantidad,p);
 }
 
-template<typename T>
-bool CartasEnlazadas<T>::esVacia() const{
+template <typename T, Nat N>
+int CartasEnlazadas<T, N>::puntosDelJugador(const T& target) const{
+	Nodo* nodo=buscar(target);
+	assert(nodo!=NULL);
+	return puntajeDe(nodo);
+}
+
+template <typename T, Nat N>
+const T& CartasEnlazadas<T, N>::ganador() const{
+	assert(this->len>0);
+	indexar();
+	return this->manijas.nodoEn(this->indice.maximo())->jugador;
+}
+
+template <typename T, Nat N>
+Nat CartasEnlazadas<T, N>::posicionDelJugador(const T& target) const{
+	Nodo* nodo=buscar(target);
+	assert(nodo!=NULL);
+	indexar();
+	return this->len - this->indice.contarMenores(puntajeDe(nodo),true) + 1;
+}
+
+template <typename T, Nat N>
+template <typename K>
+typename SiEsClave<T, K, bool>::type CartasEnlazadas<T, N>::existeJugador(const K& clave) const{
+	return buscar(clave)!=NULL;
+}
+
+template <typename T, Nat N>
+template <typename K>
+typename SiEsClave<T, K, int>::type CartasEnlazadas<T, N>::puntosDelJugador(const K& clave) const{
+	Nodo* nodo=buscar(clave);
+	assert(nodo!=NULL);
+	return puntajeDe(nodo);
+}
+
+template <typename T, Nat N>
+template <typename K>
+typename SiEsClave<T, K, Nat>::type CartasEnlazadas<T, N>::posicionDelJugador(const K& clave) const{
+	Nodo* nodo=buscar(clave);
+	assert(nodo!=NULL);
+	indexar();
+	return this->len - this->indice.contarMenores(puntajeDe(nodo),true) + 1;
+}
+
+template <typename T, Nat N>
+Nat CartasEnlazadas<T, N>::posicionDelJugador(const Manija& m) const{
+	Nodo* nodo=this->manijas.resolver(m);
+	assert(nodo!=NULL);
+	indexar();
+	return this->len - this->indice.contarMenores(puntajeDe(nodo),true) + 1;
+}
+
+template <typename T, Nat N>
+vector<T> CartasEnlazadas<T, N>::mejoresJugadores(Nat k) const{
+	indexar();
+	vector<unsigned int> ranuras;
+	this->indice.mayores(k,ranuras);
+	vector<T> res;
+	res.reserve(ranuras.size());
+	for(Nat i=0;i<ranuras.size();i++){
+		res.push_back(this->manijas.nodoEn(ranuras[i])->jugador);
+	}
+	return res;
+}
+
+template <typename T, Nat N>
+Nat CartasEnlazadas<T, N>::cantidadDeJugadoresConPuntajeEntre(int desde, int hasta) const{
+	if(desde>hasta){
+		return 0;
+	}
+	indexar();
+	return this->indice.contarMenores(hasta,true) - this->indice.contarMenores(desde,false);
+}
+
+template <typename T, Nat N>
+void CartasEnlazadas<T, N>::indexar() const{
+	if(!this->indiceAlDia){
+		this->indice.vaciar();
+		Nodo* nodo=this->jMazoAzul;
+		for(Nat i=0;i<this->len;i++){
+			this->indice.insertar(nodo->ranura,puntajeDe(nodo));
+			nodo=nodo->siguiente;
+		}
+		this->indiceAlDia=true;
+		this->armados++;
+	}
+}
+
+template <typename T, Nat N>
+void CartasEnlazadas<T, N>::indexarAlta(const Nodo* nodo){
+	if(this->indiceAlDia){
+		this->indice.insertar(nodo->ranura,puntajeDe(nodo));
+	}
+}
+
+template <typename T, Nat N>
+void CartasEnlazadas<T, N>::indexarBaja(const Nodo* nodo){
+	if(this->indiceAlDia){
+		this->indice.quitar(nodo->ranura);
+	}
+}
+
+template <typename T, Nat N>
+bool CartasEnlazadas<T, N>::esValida(const Manija& m) const{
+	return this->manijas.resolver(m)!=NULL;
+}
+
+template <typename T, Nat N>
+const T& CartasEnlazadas<T, N>::jugador(const Manija& m) const{
+	Nodo* nodo=this->manijas.resolver(m);
+	assert(nodo!=NULL);
+	return nodo->jugador;
+}
+
+template <typename T, Nat N>
+void CartasEnlazadas<T, N>::eliminarJugador(const Manija& m){
+	Nodo* nodo=this->manijas.resolver(m);
+	if(nodo!=NULL){
+		resolverMazos();
+		informar(CAMBIO_ELIMINAR,nodo,0);
+		quitarNodo(nodo);
+		compactarPaso();
+	}
+}
+
+template <typename T, Nat N>
+void CartasEnlazadas<T, N>::sumarPuntosAlJugador(const Manija& m, int p){
+	Nodo* nodo=this->manijas.resolver(m);
+	assert(nodo!=NULL);
+	sumarPuntos(nodo,p);
+}
+
+template <typename T, Nat N>
+int CartasEnlazadas<T, N>::puntosDelJugador(const Manija& m) const{
+	Nodo* nodo=this->manijas.resolver(m);
+	assert(nodo!=NULL);
+	return puntajeDe(nodo);
+}
+
+template <typename T, Nat N>
+bool CartasEnlazadas<T, N>::esVacia() const{
 	return this->len==0;
 }
 
-template<typename T>
-int CartasEnlazadas<T>::tamanio() const{
+template <typename T, Nat N>
+int CartasEnlazadas<T, N>::tamanio() const{
 	return this->len;
+}
+
+template <typename T, Nat N>
+void CartasEnlazadas<T, N>::diferirBorrado(bool d){
+	this->borradoDiferido=d;
+	if(!d){
+		this->compactando=NULL;
+	}
+}
+
+template <typename T, Nat N>
+bool CartasEnlazadas<T, N>::difiereBorrado() const{
+	return this->borradoDiferido;
+}
+
+template <typename T, Nat N>
+int CartasEnlazadas<T, N>::cantidadDeLapidas() const{
+	return this->arena.lapidas();
+}
+
+template <typename T, Nat N>
+void CartasEnlazadas<T, N>::conectarCanal(CanalDeCambios<T>* canal){
+	this->canal=canal;
+	this->fotoPendiente=canal!=NULL && this->len!=0;
+	actualizarCanal();
+}
+
+template <typename T, Nat N>
+bool CartasEnlazadas<T, N>::actualizarCanal(){
+	if(this->canal==NULL || !this->fotoPendiente){
+		return true;
+	}
+	resolverMazos();
+	size_t cambios=1+this->len;
+	long rojo=0;
+	Nodo* nodo=this->jMazoAzul;
+	for(Nat i=0;i<this->len;i++){
+		if(puntajeDe(nodo)!=0){
+			cambios++;
+		}
+		if(nodo==this->jMazoRojo){
+			rojo=i;
+		}
+		nodo=nodo->siguiente;
+	}
+	if(rojo!=0){
+		cambios++;
+	}
+	if(this->canal->lugarLibre()<cambios){
+		return false;
+	}
+	bool entro=this->canal->emitir(Cambio<T>(CAMBIO_FOTO,this->len));
+	// cada agregado se sienta a continuación del mazo azul: después del
+	// primero van de atrás para adelante
+	for(Nat i=0;i<this->len;i++){
+		entro=this->canal->emitir(Cambio<T>(CAMBIO_AGREGAR,nodo->jugador,0)) && entro;
+		nodo=nodo->anterior;
+	}
+	for(Nat i=0;i<this->len;i++){
+		if(puntajeDe(nodo)!=0){
+			entro=this->canal->emitir(Cambio<T>(CAMBIO_PUNTOS,nodo->jugador,puntajeDe(nodo))) && entro;
+		}
+		nodo=nodo->siguiente;
+	}
+	if(rojo!=0){
+		entro=this->canal->emitir(Cambio<T>(CAMBIO_MAZO_ROJO,rojo)) && entro;
+	}
+	// sólo el productor escribe, así que el lugar que se vio sigue estando
+	assert(entro);
+	this->fotoPendiente=false;
+	return true;
+}
+
+template <typename T, Nat N>
+void CartasEnlazadas<T, N>::emitir(const Cambio<T>& cambio, bool yaAplicado){
+	if(this->canal==NULL){
+		return;
+	}
+	if(this->fotoPendiente && (!actualizarCanal() || yaAplicado)){
+		return;
+	}
+	if(!this->canal->emitir(cambio)){
+		this->fotoPendiente=true;
+	}
+}
+
+template <typename T, Nat N>
+bool CartasEnlazadas<T, N>::estaCompactando() const{
+	return this->compactando!=NULL;
 }	
 
-template <typename T>
-bool CartasEnlazadas<T>::operator==(const CartasEnlazadas<T>& juego2) const {
+template <typename T, Nat N>
+size_t CartasEnlazadas<T, N>::memoriaUtilizada() const{
+	return sizeof(*this) + (this->len - this->almacen.enUso())*sizeof(Nodo) + this->arena.memoriaOciosa()
+		+ this->manijas.memoriaUtilizada() + this->indice.memoriaUtilizada() + this->asientos.memoriaUtilizada()
+		+ this->sucios.capacity()*sizeof(Manija) + this->quitados.capacity()*sizeof(T)
+		+ this->cursores.capacity()*sizeof(DatosCursor)
+		+ (this->cursoresPendientes.capacity() + this->cursoresLibres.capacity() + this->primerosCursores.capacity())*sizeof(Nat);
+}
+
+template <typename T, Nat N>
+bool CartasEnlazadas<T, N>::operator==(const CartasEnlazadas<T, N>& juego2) const {
+	resolverMazos();
+	juego2.resolverMazos();
 	bool res=false;
 	if(this->len==0 && (juego2.tamanio())==0){res=true;}else{
 		if((this->len==juego2.len) && (this->jMazoRojo->jugador == juego2.jMazoRojo->jugador)){
@@ -474,7 +2744,7 @@ bool CartasEnlazadas<T>::operator==(const CartasEnlazadas<T>& juego2) const {
 			Nodo* elementoJuego2=juego2.jMazoAzul;
 			int i=this->len;
 			while(i>0 && res==true){
-				res= res && ((elementoThis->jugador == elementoJuego2->jugador) && (elementoThis->puntaje == elementoJuego2->puntaje));
+				res= res && ((elementoThis->jugador == elementoJuego2->jugador) && (puntajeDe(elementoThis) == juego2.puntajeDe(elementoJuego2)));
 				elementoThis=elementoThis->siguiente;
 				elementoJuego2=elementoJuego2->siguiente;
 				i--;
@@ -486,6 +2756,30 @@ bool CartasEnlazadas<T>::operator==(const CartasEnlazadas<T>& juego2) const {
 }
 
 
+template <typename T, Nat N>
+typename CartasEnlazadas<T, N>::const_iterator CartasEnlazadas<T, N>::begin() const{
+	resolverMazos();
+	return const_iterator(this, this->jMazoAzul, 0);
+}
+
+template <typename T, Nat N>
+typename CartasEnlazadas<T, N>::const_iterator CartasEnlazadas<T, N>::end() const{
+	resolverMazos();
+	return const_iterator(this, this->jMazoAzul, this->len);
+}
+
+template <typename T, Nat N>
+typename CartasEnlazadas<T, N>::Vista CartasEnlazadas<T, N>::vistaDesdeMazoRojo() const{
+	resolverMazos();
+	return Vista(const_iterator(this, this->jMazoRojo, 0), const_iterator(this, this->jMazoRojo, this->len));
+}
+
+template <typename T, Nat N>
+typename CartasEnlazadas<T, N>::Vista CartasEnlazadas<T, N>::vistaDesdeMazoAzul() const{
+	return Vista(begin(), end());
+}
+
+
 #endif //CARTAS_ENLAZADAS_H_
 
 
@@ -0,0 +1,36 @@
+#ifndef CLAVES_H_
+#define CLAVES_H_
+
+#include <type_traits>
+#include <utility>
+#include "manijas.h"
+using namespace std;
+
+/**
+ * EsClaveDe<T, K>::valor dice si las búsquedas pueden usar un K como clave
+ * de un T: un T se compara con un K mediante ==, y K no es T (para eso están
+ * las versiones de siempre) ni Manija (que tiene sus propias versiones).
+ */
+template<typename T, typename K>
+class EsClaveDe {
+
+	template<typename A, typename B>
+	static char probar(decltype((void)(declval<const A&>() == declval<const B&>()))*);
+
+	template<typename A, typename B>
+	static long probar(...);
+
+  public:
+
+	static const bool valor = sizeof(probar<T, K>(0)) == sizeof(char)
+		&& !is_same<T, K>::value && !is_same<K, Manija>::value;
+};
+
+/**
+ * SiEsClave<T, K, R>::tipo es R si K es clave de T, y no existe si no, así
+ * las versiones por clave no compiten con las demás.
+ */
+template<typename T, typename K, typename R>
+struct SiEsClave : enable_if<EsClaveDe<T, K>::valor, R> {};
+
+#endif // CLAVES_H_
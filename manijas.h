@@ -0,0 +1,132 @@
+#ifndef MANIJAS_H_
+#define MANIJAS_H_
+
+#include <cstddef>
+#include <vector>
+using namespace std;
+
+/**
+ * Manija generacional de un elemento de un contenedor: la ranura donde está
+ * registrado su nodo y la generación de esa ranura al momento de registrarlo.
+ * Cuando el elemento se elimina la ranura cambia de generación, así que las
+ * manijas viejas dejan de ser válidas aunque la ranura se vuelva a usar.
+ * Una manija sólo tiene sentido en el contenedor que la devolvió.
+ */
+struct Manija {
+	unsigned int ranura;
+	unsigned int generacion;
+};
+
+inline bool operator==(const Manija& a, const Manija& b) {
+	return a.ranura == b.ranura && a.generacion == b.generacion;
+}
+
+inline bool operator!=(const Manija& a, const Manija& b) {
+	return !(a == b);
+}
+
+/**
+ * Manija que no corresponde a ningún elemento de ningún contenedor.
+ */
+const Manija MANIJA_INVALIDA = { ~0u, 0 };
+
+/**
+ * Tabla de ranuras de un contenedor: lleva de una manija al nodo en O(1).
+ * Las ranuras liberadas se reutilizan.
+ */
+template<typename Nodo>
+class TablaDeManijas {
+
+  public:
+
+	/**
+	 * Registra el nodo en una ranura libre y devuelve su manija.
+	 */
+	Manija registrar(Nodo* n) {
+		Manija m;
+		if(libres.empty()){
+			m.ranura = ranuras.size();
+			Ranura r;
+			r.nodo = n;
+			r.generacion = 0;
+			ranuras.push_back(r);
+		}else{
+			m.ranura = libres.back();
+			libres.pop_back();
+			ranuras[m.ranura].nodo = n;
+		}
+		m.generacion = ranuras[m.ranura].generacion;
+		return m;
+	}
+
+	/**
+	 * Libera la ranura; las manijas que apuntaban a ella quedan inválidas.
+	 */
+	void liberar(unsigned int ranura) {
+		ranuras[ranura].nodo = NULL;
+		ranuras[ranura].generacion++;
+		libres.push_back(ranura);
+	}
+
+	/**
+	 * Devuelve el nodo de la manija, o NULL si la manija no es válida.
+	 */
+	Nodo* resolver(const Manija& m) const {
+		if(m.ranura >= ranuras.size() || ranuras[m.ranura].generacion != m.generacion){
+			return NULL;
+		}
+		return ranuras[m.ranura].nodo;
+	}
+
+	/**
+	 * Cambia el nodo de una ranura ocupada (cuando el nodo se muda de lugar),
+	 * sin invalidar sus manijas.
+	 */
+	void reubicar(unsigned int ranura, Nodo* n) {
+		ranuras[ranura].nodo = n;
+	}
+
+	/**
+	 * Devuelve la manija vigente de una ranura ocupada.
+	 */
+	Manija manija(unsigned int ranura) const {
+		Manija m;
+		m.ranura = ranura;
+		m.generacion = ranuras[ranura].generacion;
+		return m;
+	}
+
+	/**
+	 * Devuelve el nodo registrado en una ranura ocupada.
+	 */
+	Nodo* nodoEn(unsigned int ranura) const {
+		return ranuras[ranura].nodo;
+	}
+
+	/**
+	 * Devuelve la cantidad de ranuras (ocupadas o libres). Las ranuras se
+	 * numeran desde 0, así que sirve para dimensionar arreglos por ranura.
+	 */
+	unsigned int cantidadDeRanuras() const {
+		return ranuras.size();
+	}
+
+	/**
+	 * Bytes que ocupa la tabla fuera del objeto.
+	 */
+	size_t memoriaUtilizada() const {
+		return ranuras.capacity() * sizeof(Ranura) + libres.capacity() * sizeof(unsigned int);
+	}
+
+  private:
+
+	struct Ranura {
+		Nodo* nodo;
+		unsigned int generacion;
+	};
+
+	vector<Ranura> ranuras;
+	vector<unsigned int> libres;
+};
+
+#endif // MANIJAS_H_
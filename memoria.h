@@ -0,0 +1,233 @@
+#ifndef MEMORIA_H_
+#define MEMORIA_H_
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <vector>
+using namespace std;
+
+/**
+ * Contador global de la memoria que los contenedores piden al heap para sus
+ * nodos. Cuenta los bytes de cada nodo (sizeof), no lo que agrega el
+ * asignador ni la memoria que use el propio T. Se puede consultar desde
+ * cualquier hilo; los contadores son atómicos y no sincronizan nada más.
+ */
+class ContadorDeMemoria {
+
+  public:
+
+	/**
+	 * Bytes de nodos reservados y todavía no liberados.
+	 */
+	static long bytesEnUso() { return datos().enUso.load(memory_order_relaxed); }
+
+	/**
+	 * Cantidad de nodos pedidos al heap y devueltos desde que arrancó el programa.
+	 */
+	static unsigned long reservas() { return datos().reservas.load(memory_order_relaxed); }
+	static unsigned long liberaciones() { return datos().liberaciones.load(memory_order_relaxed); }
+
+	static void reservar(size_t bytes) {
+		datos().enUso.fetch_add(bytes, memory_order_relaxed);
+		datos().reservas.fetch_add(1, memory_order_relaxed);
+	}
+
+	static void liberar(size_t bytes) {
+		datos().enUso.fetch_sub(bytes, memory_order_relaxed);
+		datos().liberaciones.fetch_add(1, memory_order_relaxed);
+	}
+
+  private:
+
+	struct Datos {
+		atomic<long> enUso;
+		atomic<unsigned long> reservas;
+		atomic<unsigned long> liberaciones;
+		Datos() : enUso(0), reservas(0), liberaciones(0) {}
+	};
+
+	static Datos& datos() {
+		static Datos d;
+		return d;
+	}
+};
+
+/**
+ * Crea un nodo en el heap y lo anota en el contador.
+ */
+template<typename Nodo, typename A>
+Nodo* crearNodo(const A& a) {
+	Nodo* n = new Nodo(a);
+	ContadorDeMemoria::reservar(sizeof(Nodo));
+	return n;
+}
+
+/**
+ * Libera un nodo creado con crearNodo.
+ */
+template<typename Nodo>
+void destruirNodo(Nodo* n) {
+	delete n;
+	ContadorDeMemoria::liberar(sizeof(Nodo));
+}
+
+/**
+ * Arena de nodos para el borrado diferido. Los nodos se construyen uno detrás
+ * de otro en bloques contiguos (cada bloque del doble que el anterior) y al
+ * destruir uno su lugar queda como lápida hasta que se libera la generación
+ * entera. El contenedor compacta mudando sus nodos vivos, en el orden de la
+ * ronda, a una generación nueva: cuando la vieja se queda sin nodos vivos sus
+ * bloques se devuelven al heap.
+ */
+template<typename Nodo>
+class ArenaNodos {
+
+  public:
+
+	ArenaNodos() {}
+
+	/**
+	 * PRE: el contenedor ya destruyó todos sus nodos.
+	 */
+	~ArenaNodos() {
+		actual.liberar();
+		vieja.liberar();
+	}
+
+	template<typename A>
+	Nodo* crear(const A& a) { return actual.crear(a); }
+
+	/**
+	 * Destruye el nodo; su lugar queda como lápida.
+	 * PRE: el nodo es de la arena.
+	 */
+	void destruir(Nodo* n) {
+		if(actual.contiene(n)){
+			actual.destruir(n);
+		}else{
+			vieja.destruir(n);
+		}
+	}
+
+	bool esPropio(const Nodo* n) const { return actual.contiene(n) || vieja.contiene(n); }
+
+	/**
+	 * Dice si el nodo es de la generación actual (no hay que mudarlo).
+	 */
+	bool esNuevo(const Nodo* n) const { return actual.contiene(n); }
+
+	/**
+	 * Lápidas de las dos generaciones.
+	 */
+	size_t lapidas() const { return actual.usados - actual.vivos + vieja.usados - vieja.vivos; }
+
+	/**
+	 * Nodos vivos de la generación actual.
+	 */
+	size_t vivos() const { return actual.vivos; }
+
+	/**
+	 * Bytes de los bloques que no ocupa ningún nodo vivo: las lápidas y el
+	 * lugar todavía sin usar.
+	 */
+	size_t memoriaOciosa() const {
+		return actual.reservada() + vieja.reservada() - (actual.vivos + vieja.vivos) * sizeof(Nodo);
+	}
+
+	/**
+	 * La generación actual pasa a ser vieja (junto con lo que quedara de la
+	 * anterior) y los nodos nuevos van a una generación vacía.
+	 */
+	void nuevaGeneracion() {
+		for(size_t i = 0; i < actual.bloques.size(); i++){
+			vieja.bloques.push_back(actual.bloques[i]);
+		}
+		vieja.usados += actual.usados;
+		vieja.vivos += actual.vivos;
+		actual.bloques.clear();
+		actual.usados = 0;
+		actual.vivos = 0;
+		if(vieja.vivos == 0){
+			vieja.liberar();
+		}
+	}
+
+  private:
+
+	ArenaNodos(const ArenaNodos&);
+	ArenaNodos& operator=(const ArenaNodos&);
+
+	struct Bloque {
+		unsigned char* datos;
+		size_t capacidad;
+		size_t usados;
+	};
+
+	struct Generacion {
+		std::vector<Bloque> bloques;
+		size_t usados;
+		size_t vivos;
+
+		Generacion() : usados(0), vivos(0) {}
+
+		template<typename A>
+		Nodo* crear(const A& a) {
+			if(bloques.empty() || bloques.back().usados == bloques.back().capacidad){
+				Bloque b;
+				b.capacidad = bloques.empty() ? 16 : 2 * bloques.back().capacidad;
+				b.datos = static_cast<unsigned char*>(::operator new(b.capacidad * sizeof(Nodo)));
+				b.usados = 0;
+				ContadorDeMemoria::reservar(b.capacidad * sizeof(Nodo));
+				bloques.push_back(b);
+			}
+			Bloque& b = bloques.back();
+			Nodo* n = new (b.datos + b.usados * sizeof(Nodo)) Nodo(a);
+			b.usados++;
+			usados++;
+			vivos++;
+			return n;
+		}
+
+		void destruir(Nodo* n) {
+			n->~Nodo();
+			vivos--;
+			if(vivos == 0){
+				liberar();
+			}
+		}
+
+		bool contiene(const Nodo* n) const {
+			const unsigned char* c = (const unsigned char*)n;
+			for(size_t i = 0; i < bloques.size(); i++){
+				if(c >= bloques[i].datos && c < bloques[i].datos + bloques[i].capacidad * sizeof(Nodo)){
+					return true;
+				}
+			}
+			return false;
+		}
+
+		size_t reservada() const {
+			size_t res = 0;
+			for(size_t i = 0; i < bloques.size(); i++){
+				res += bloques[i].capacidad * sizeof(Nodo);
+			}
+			return res;
+		}
+
+		void liberar() {
+			for(size_t i = 0; i < bloques.size(); i++){
+				::operator delete(bloques[i].datos);
+				ContadorDeMemoria::liberar(bloques[i].capacidad * sizeof(Nodo));
+			}
+			bloques.clear();
+			usados = 0;
+			vivos = 0;
+		}
+	};
+
+	Generacion actual;
+	Generacion vieja;
+};
+
+#endif // MEMORIA_H_
@@ -1,12 +1,23 @@
 // g++ -g tests.cpp -o tests
+// g++ -std=c++20 -g tests.cpp -o tests (para probar también EjecutorCorrutinas.h)
 // valgrind --leak-check=full -v ./tests
 // g++ -g tests.cpp -o niwagato
 // ddd ./niwagato
 //breakpoint con doble click, después run y hacerle doble click al objeto que quiero ver
 
 #include <algorithm>
+#include <vector>
 #include "mini_test.h"
 #include "PlanificadorRR.h"
+#include "PlanificadorRRFijo.h"
+#include "cartas_enlazadas.h"
+#include "GrupoPlanificadorRR.h"
+#include "SimuladorTorneos.h"
+#include "CartasPublicadas.h"
+#include <thread>
+#if defined(__cpp_impl_coroutine)
+#include "EjecutorCorrutinas.h"
+#endif
 
 using namespace std;
 
@@ -115,7 +126,1596 @@ void PlanifdePlanif()
   // ASSERT_EQ(to_s(p1))
 }
 
+void iteradoresPlanificador()
+{
+  PlanificadorRR<int> p1;
+  ASSERT(p1.begin() == p1.end());
+  ASSERT(p1.vistaActivos().empty());
+  p1.agregarProceso(1);
+  p1.agregarProceso(2);
+  p1.agregarProceso(3);
+  p1.pausarProceso(2);
+  vector<int> todos(p1.begin(), p1.end());
+  ASSERT_EQ((int) todos.size(), 3);
+  ASSERT_EQ(todos[0], 1);
+  ASSERT_EQ(todos[1], 2);
+  ASSERT_EQ(todos[2], 3);
+  ASSERT(p1.begin().ejecutado());
+  PlanificadorRR<int>::Vista activos = p1.vistaActivos();
+  ASSERT_EQ((int) distance(activos.begin(), activos.end()), p1.cantidadDeProcesosActivos());
+  ASSERT(find(activos.begin(), activos.end(), 2) == activos.end());
+  PlanificadorRR<int>::const_iterator it = p1.end();
+  --it;
+  ASSERT_EQ(*it, 3);
+  --it;
+  ASSERT_EQ(*it, 2);
+  ASSERT(!it.activo());
+}
+
+void iteradoresCartas()
+{
+  CartasEnlazadas<int> c;
+  ASSERT(c.begin() == c.end());
+  c.agregarJugador(1);
+  c.agregarJugador(2);
+  c.agregarJugador(3);
+  c.sumarPuntosAlJugador(2, 5);
+  c.adelantarMazoRojo(1);
+  vector<int> ronda(c.begin(), c.end());
+  ASSERT_EQ((int) ronda.size(), 3);
+  ASSERT_EQ(ronda[0], 1);
+  ASSERT_EQ(ronda[1], 3);
+  ASSERT_EQ(ronda[2], 2);
+  CartasEnlazadas<int>::Vista roja = c.vistaDesdeMazoRojo();
+  ASSERT_EQ(*roja.begin(), 3);
+  ASSERT(roja.begin().tieneMazoRojo());
+  CartasEnlazadas<int>::const_iterator it = find(c.begin(), c.end(), 2);
+  ASSERT_EQ(it.puntaje(), 5);
+  ASSERT_EQ((int) count(c.vistaDesdeMazoAzul().begin(), c.vistaDesdeMazoAzul().end(), 3), 1);
+}
+void mazosDiferidos()
+{
+  CartasEnlazadas<int> c;
+  c.agregarJugador(1);
+  c.agregarJugador(2);
+  c.agregarJugador(3);
+  c.agregarJugador(4);
+  // la ronda es [1 4 3 2]
+  for (int i = 0; i < 1001; i++) {
+    c.adelantarMazoRojo(3);
+    c.adelantarMazoAzul(-1);
+  }
+  ASSERT_EQ(c.dameJugadorConMazoRojo(), 2);
+  ASSERT_EQ(c.dameJugadorConMazoAzul(), 2);
+  ASSERT_EQ(c.dameJugador(-5), 3);
+  ASSERT_EQ(c.dameJugadorEnfrentado(), 4);
+  c.adelantarMazoAzul(2);
+  c.agregarJugador(5);
+  ASSERT_EQ(to_s(c), "[(4,0),(5,0),(3,0),(2,0)*,(1,0)]");
+  c.adelantarMazoRojo(1);
+  c.eliminarJugador(3);
+  ASSERT_EQ(c.dameJugadorConMazoRojo(), 1);
+  CartasEnlazadas<int> copia(c);
+  ASSERT(copia == c);
+}
+void mesaChica()
+{
+  CartasEnlazadas<int, 2> c;
+  c.agregarJugador(1);
+  c.agregarJugador(2);
+  c.agregarJugador(3);
+  c.agregarJugador(4);
+  c.sumarPuntosAlJugador(3, 7);
+  c.eliminarJugador(1);
+  c.eliminarJugador(4);
+  c.agregarJugador(5);
+  ASSERT_EQ(to_s(c), "[(3,7)*,(5,0),(2,0)]");
+  CartasEnlazadas<int, 2> copia(c);
+  ASSERT(copia == c);
+  ASSERT_EQ(copia.ganador(), 3);
+}
+void eliminarCadaK()
+{
+  CartasEnlazadas<int> lote;
+  for (int i = 1; i <= 9; i++) {
+    lote.agregarJugador(i);
+    lote.sumarPuntosAlJugador(i, i * 10);
+  }
+  lote.adelantarMazoRojo(4);
+  CartasEnlazadas<int> paso(lote);
+  vector<int> orden = lote.eliminarCadaK(-5, 6);
+  ASSERT_EQ((int) orden.size(), 6);
+  for (int i = 0; i < 6; i++) {
+    paso.adelantarMazoAzul(-5);
+    ASSERT_EQ(orden[i], paso.dameJugadorConMazoAzul());
+    paso.eliminarJugadorConMazoAzul();
+  }
+  ASSERT(lote == paso);
+  ASSERT_EQ(to_s(lote), to_s(paso));
+  ASSERT_EQ(lote.dameJugadorConMazoRojo(), paso.dameJugadorConMazoRojo());
+  vector<int> resto = lote.eliminarCadaK(3, 3);
+  ASSERT_EQ((int) resto.size(), 3);
+  ASSERT(lote.esVacia());
+}
+void grupoRobaYBalancea()
+{
+  GrupoPlanificadorRR<int> g(3);
+  for (int i = 0; i < 6; i++) {
+    g.agregarProceso(0, i);
+  }
+  ASSERT_EQ(g.cantidadDeProcesosActivos(1), 0);
+  ASSERT(g.ejecutarSiguienteProceso(1));
+  ASSERT_EQ(g.cantidadDeProcesosActivos(0), 3);
+  ASSERT_EQ(g.cantidadDeProcesosActivos(1), 3);
+  ASSERT_EQ(g.nucleoDe(g.procesoEjecutado(1)), 1);
+  ASSERT_EQ(g.balancear(), 2);
+  ASSERT_EQ(g.cantidadDeProcesosActivos(2), 2);
+  ASSERT_EQ(g.cantidadDeProcesos(), 6);
+  g.pausarProceso(0);
+  ASSERT(!g.estaActivo(0));
+  ASSERT_EQ(g.cantidadDeProcesosActivos(), 5);
+  g.detener();
+  ASSERT(g.detenido());
+  ASSERT(!g.ejecutarSiguienteProceso(2));
+  g.reanudar();
+  g.eliminarProceso(0);
+  ASSERT(!g.esPlanificado(0));
+}
+
+void grupoConHilos()
+{
+  GrupoPlanificadorRR<int> g(4);
+  for (int i = 0; i < 40; i++) {
+    g.agregarProceso(0, i);
+  }
+  vector<thread> hilos;
+  for (unsigned int n = 0; n < 4; n++) {
+    hilos.push_back(thread([&g, n]() {
+      for (int i = 0; i < 2000; i++) {
+        g.ejecutarSiguienteProceso(n);
+        if (n == 0 && i % 100 == 0) {
+          g.balancear();
+        }
+      }
+    }));
+  }
+  // robar y balancear mueven procesos mientras se los busca por nombre
+  hilos.push_back(thread([&g]() {
+    for (int i = 0; i < 2000; i++) {
+      g.pausarProceso(i % 40);
+      ASSERT(!g.estaActivo(i % 40));
+      g.reanudarProceso(i % 40);
+    }
+  }));
+  for (unsigned int n = 0; n < hilos.size(); n++) {
+    hilos[n].join();
+  }
+  ASSERT_EQ(g.cantidadDeProcesos(), 40);
+  ASSERT_EQ(g.cantidadDeProcesosActivos(), 40);
+  for (unsigned int n = 0; n < 4; n++) {
+    ASSERT(g.cantidadDeProcesosActivos(n) > 0);
+  }
+}
+
+void manijas()
+{
+  PlanificadorRR<int> p1;
+  Manija m1 = p1.agregarProceso(1);
+  Manija m2 = p1.agregarProceso(2);
+  Manija m3 = p1.agregarProceso(3);
+  ASSERT_EQ(p1.proceso(m2), 2);
+  p1.pausarProceso(m1);
+  ASSERT(!p1.estaActivo(1));
+  ASSERT_EQ(p1.procesoEjecutado(), 2);
+  p1.reanudarProceso(m1);
+  p1.eliminarProceso(m2);
+  ASSERT(!p1.esValida(m2));
+  Manija otra = p1.agregarProceso(2);
+  ASSERT(!p1.esValida(m2));
+  ASSERT(p1.esValida(otra));
+  ASSERT(p1.esValida(m3));
+  ASSERT_EQ(to_s(p1), "[3*, 1, 2]");
+
+  CartasEnlazadas<int, 2> c;
+  Manija j1 = c.agregarJugador(1);
+  Manija j2 = c.agregarJugador(2);
+  Manija j3 = c.agregarJugador(3);
+  c.sumarPuntosAlJugador(j3, 4);
+  ASSERT_EQ(c.puntosDelJugador(3), 4);
+  ASSERT_EQ(c.puntosDelJugador(j3), 4);
+  c.eliminarJugador(j1);
+  c.eliminarJugador(j1);
+  ASSERT_EQ(c.tamanio(), 2);
+  ASSERT(!c.esValida(j1));
+  ASSERT_EQ(c.jugador(j2), 2);
+  ASSERT_EQ(c.dameJugadorConMazoAzul(), 3);
+}
+bool esPar(const int& x)
+{
+  return x % 2 == 0;
+}
+
+void empalmes()
+{
+  PlanificadorRR<int> a;
+  PlanificadorRR<int> b;
+  for (int i = 1; i <= 6; i++) {
+    a.agregarProceso(i);
+  }
+  b.agregarProceso(10);
+  a.pausarProceso(3);
+  a.ejecutarSiguienteProceso();
+  ASSERT_EQ(to_s(a), "[2*, 3 (i), 4, 5, 6, 1]");
+  b.transferirProcesos(a, 1, 3);
+  ASSERT_EQ(to_s(a), "[4*, 5, 6]");
+  ASSERT_EQ(to_s(b), "[10*, 1, 2, 3 (i)]");
+  ASSERT_EQ(b.cantidadDeProcesosActivos(), 3);
+  PlanificadorRR<int> c;
+  b.separar(c, esPar);
+  ASSERT_EQ(to_s(b), "[1*, 3 (i)]");
+  ASSERT_EQ(to_s(c), "[10*, 2]");
+  c.unir(a);
+  ASSERT(!a.hayProcesos());
+  ASSERT_EQ(to_s(c), "[10*, 2, 4, 5, 6]");
+
+  CartasEnlazadas<int, 4> m1;
+  for (int i = 1; i <= 5; i++) {
+    m1.agregarJugador(i);
+    m1.sumarPuntosAlJugador(i, i);
+  }
+  m1.adelantarMazoRojo(2);
+  ASSERT_EQ(to_s(m1), "[(1,1),(5,5),(4,4)*,(3,3),(2,2)]");
+  CartasEnlazadas<int, 4> m3;
+  m3.agregarJugador(9);
+  m3.transferirJugadores(m1, 5, 3);
+  ASSERT_EQ(to_s(m1), "[(1,1),(2,2)*]");
+  ASSERT_EQ(to_s(m3), "[(9,0)*,(5,5),(4,4),(3,3)]");
+  CartasEnlazadas<int, 4> m4;
+  m3.separar(m4, esPar);
+  ASSERT_EQ(to_s(m4), "[(4,4)*]");
+  m4.unir(m3);
+  m4.unir(m1);
+  ASSERT_EQ(m3.tamanio(), 0);
+  ASSERT_EQ(to_s(m4), "[(4,4)*,(1,1),(2,2),(9,0),(5,5),(3,3)]");
+  ASSERT_EQ(m4.puntosDelJugador(5), 5);
+}
+
+void gruposDeProcesos()
+{
+  PlanificadorRR<int> a;
+  a.agregarProceso(1);
+  unsigned int g = a.crearGrupo();
+  for (int i = 2; i <= 4; i++) {
+    a.agregarProceso(i, g);
+  }
+  a.pausarProceso(3);
+  a.ejecutarSiguienteProceso();
+  ASSERT_EQ(to_s(a), "[2*, 3 (i), 4, 1]");
+  a.pausarGrupo(g);
+  ASSERT(a.grupoPausado(g));
+  ASSERT_EQ(to_s(a), "[1*, 2 (i), 3 (i), 4 (i)]");
+  ASSERT_EQ(a.cantidadDeProcesosActivos(), 1);
+  ASSERT_EQ(a.cantidadDeProcesosDelGrupo(g), 3);
+  ASSERT(!a.estaActivo(4));
+  PlanificadorRR<int> b(a);
+  ASSERT(b == a);
+  ASSERT_EQ(b.cantidadDeProcesosActivos(), 1);
+  a.pausarProceso(4);
+  a.reanudarGrupo(g);
+  ASSERT_EQ(to_s(a), "[1*, 2, 3 (i), 4 (i)]");
+  ASSERT_EQ(a.cantidadDeProcesosActivos(), 2);
+  a.pausarProceso(1);
+  ASSERT_EQ(to_s(a), "[2*, 3 (i), 4 (i), 1 (i)]");
+  a.eliminarProceso(2);
+  ASSERT_EQ(a.cantidadDeProcesosDelGrupo(g), 2);
+  ASSERT(!a.hayProcesosActivos());
+  b.reanudarGrupo(g);
+  ASSERT_EQ(to_s(b), "[1*, 2, 3 (i), 4]");
+  ASSERT_EQ(b.cantidadDeProcesosActivos(), 3);
+}
+
+void cambiosDiferidos()
+{
+  PlanificadorRR<int> a;
+  a.diferirCambios(true);
+  for (int i = 1; i <= 3; i++) {
+    a.agregarProceso(i);
+  }
+  a.detener();
+  ASSERT(a.agregarProceso(4) == MANIJA_INVALIDA);
+  a.agregarProceso(5);
+  a.pausarProceso(5);
+  a.eliminarProceso(4);
+  a.pausarProceso(2);
+  a.reanudarProceso(2);
+  a.pausarProceso(1);
+  a.eliminarProceso(3);
+  ASSERT_EQ(a.cantidadDeCambiosPendientes(), 3);
+  ASSERT_EQ(to_s(a), "[1*, 2, 3]");
+  a.reanudar();
+  ASSERT_EQ(a.cantidadDeCambiosPendientes(), 0);
+  ASSERT_EQ(to_s(a), "[2*, 5 (i), 1 (i)]");
+
+  a.detener();
+  a.eliminarProceso(2);
+  a.agregarProceso(2);
+  a.diferirCambios(false);
+  ASSERT_EQ(to_s(a), "[2*, 5 (i), 1 (i)]");
+
+  // los cancelados salen de la cola y los demás siguen en orden
+  PlanificadorRR<int> b;
+  b.diferirCambios(true);
+  Manija m = b.agregarProceso(0);
+  b.detener();
+  for (int i = 1; i <= 200; i++) {
+    b.agregarProceso(i);
+    b.pausarProceso(m);
+    b.reanudarProceso(m);
+    if (i % 10 != 0) {
+      b.eliminarProceso(i);
+    }
+  }
+  b.pausarProceso(20);
+  b.pausarProceso(m);
+  ASSERT_EQ(b.cantidadDeCambiosPendientes(), 21);
+  PlanificadorRR<int> copia(b);
+  b.reanudar();
+  ASSERT_EQ(b.cantidadDeProcesos(), 21);
+  ASSERT_EQ(to_s(b).substr(0, 30), "[10*, 20 (i), 30, 40, 50, 60, ");
+  ASSERT(!b.estaActivo(0));
+  copia.reanudar();
+  ASSERT_EQ(to_s(copia), to_s(b));
+}
+
+void tablaDePosiciones()
+{
+  CartasEnlazadas<int> m;
+  vector<Manija> manijas;
+  for (int i = 1; i <= 6; i++) {
+    manijas.push_back(m.agregarJugador(i));
+    m.sumarPuntosAlJugador(i, 10 * (i % 4));
+  }
+  // puntajes: 1->10, 2->20, 3->30, 4->0, 5->10, 6->20
+  ASSERT_EQ(m.ganador(), 3);
+  ASSERT_EQ((int)m.posicionDelJugador(3), 1);
+  ASSERT_EQ((int)m.posicionDelJugador(6), 2);
+  ASSERT_EQ((int)m.posicionDelJugador(2), 2);
+  ASSERT_EQ((int)m.posicionDelJugador(manijas[0]), 4);
+  ASSERT_EQ((int)m.posicionDelJugador(4), 6);
+  ASSERT_EQ((int)m.cantidadDeJugadoresConPuntajeEntre(10, 20), 4);
+  ASSERT_EQ((int)m.cantidadDeJugadoresConPuntajeEntre(21, 29), 0);
+  m.sumarPuntosAlJugador(manijas[3], 50);
+  m.eliminarJugador(3);
+  vector<int> mejores = m.mejoresJugadores(2);
+  ASSERT_EQ((int)mejores.size(), 2);
+  ASSERT_EQ(mejores[0], 4);
+  ASSERT_EQ(m.puntosDelJugador(mejores[1]), 20);
+  ASSERT_EQ((int)m.mejoresJugadores(10).size(), 5);
+  ASSERT_EQ(m.ganador(), 4);
+  ASSERT_EQ((int)m.posicionDelJugador(1), 4);
+
+  CartasEnlazadas<int> otra;
+  otra.unir(m);
+  ASSERT_EQ(otra.ganador(), 4);
+  ASSERT_EQ((int)m.cantidadDeJugadoresConPuntajeEntre(0, 100), 0);
+  otra.agregarJugador(7);
+  otra.sumarPuntosAlJugador(7, 100);
+  ASSERT_EQ(otra.ganador(), 7);
+  ASSERT_EQ((int)otra.posicionDelJugador(4), 2);
+}
+
+void puntosPorArcos()
+{
+  CartasEnlazadas<int> m;
+  m.agregarJugador(1);
+  for (int i = 5; i >= 2; i--) {
+    m.agregarJugador(i);
+  }
+  for (int i = 1; i <= 5; i++) {
+    m.sumarPuntosAlJugador(i, i);
+  }
+  m.adelantarMazoRojo(1);
+  ASSERT_EQ(to_s(m), "[(1,1),(2,2)*,(3,3),(4,4),(5,5)]");
+  ASSERT_EQ((int)m.puntosDelArcoDesdeMazoRojo(0, 3), 9);
+  ASSERT_EQ((int)m.puntosDelArcoDesdeMazoRojo(-2, 3), 8);
+  ASSERT_EQ((int)m.puntosDelArcoDesdeMazoAzul(0, 5), 15);
+  m.sumarPuntosAlArcoDesdeMazoAzul(-1, 2, 10);
+  ASSERT_EQ(to_s(m), "[(1,11),(2,2)*,(3,3),(4,4),(5,15)]");
+  ASSERT_EQ(m.ganador(), 5);
+  m.agregarJugador(6);
+  m.eliminarJugador(3);
+  m.sumarPuntosAlJugador(6, 7);
+  ASSERT_EQ(to_s(m), "[(1,11),(6,7),(2,2)*,(4,4),(5,15)]");
+  ASSERT_EQ((int)m.puntosDelArcoDesdeMazoRojo(-1, 2), 9);
+  ASSERT_EQ(m.puntosDelJugador(4), 4);
+  CartasEnlazadas<int> copia(m);
+  ASSERT(copia == m);
+}
+
+void puntosEnLote()
+{
+  CartasEnlazadas<int> m;
+  CartasEnlazadas<int> uno;
+  for (int i = 1; i <= 5; i++) {
+    m.agregarJugador(i);
+    uno.agregarJugador(i);
+  }
+  ASSERT_EQ(to_s(m), "[(1,0)*,(5,0),(4,0),(3,0),(2,0)]");
+  vector<pair<int, int> > ronda;
+  ronda.push_back(make_pair(5, 3));
+  ronda.push_back(make_pair(3, 1));
+  ronda.push_back(make_pair(2, 4));
+  ronda.push_back(make_pair(1, 2));
+  ronda.push_back(make_pair(3, 5));
+  m.sumarPuntosEnLote(ronda.begin(), ronda.end());
+  for (unsigned int i = 0; i < ronda.size(); i++) {
+    uno.sumarPuntosAlJugador(ronda[i].first, ronda[i].second);
+  }
+  ASSERT(m == uno);
+  ASSERT_EQ(m.ganador(), 3);
+  vector<int> asientos;
+  asientos.push_back(1);
+  asientos.push_back(6);
+  m.sumarPuntosPorAsiento(asientos);
+  ASSERT_EQ(to_s(m), "[(1,3)*,(5,9),(4,0),(3,6),(2,4)]");
+  ASSERT_EQ(m.ganador(), 5);
+}
+
+void simuladorTorneos()
+{
+  ReglasTorneo reglas;
+  reglas.jugadores = 5;
+  reglas.rondas = 30;
+  reglas.eliminarCada = 10;
+  SimuladorTorneos uno(reglas, 1);
+  SimuladorTorneos cuatro(reglas, 4);
+  ResultadoTorneo a = uno.simular(500, 42);
+  ResultadoTorneo b = cuatro.simular(500, 42);
+  ASSERT_EQ((int)a.partidas, 500);
+  ASSERT_EQ((int)a.victorias.size(), 5);
+  unsigned long total = a.empates;
+  for (unsigned int i = 0; i < a.victorias.size(); i++) {
+    total += a.victorias[i];
+    ASSERT_EQ((int)a.victorias[i], (int)b.victorias[i]);
+  }
+  ASSERT_EQ((int)total, 500);
+  ASSERT_EQ((int)a.empates, (int)b.empates);
+  ResultadoTorneo c = cuatro.simular(500, 43);
+  ASSERT(c.victorias != a.victorias);
+  ASSERT_EQ((int)cuatro.simular(3, 42).partidas, 3);
+}
+
+void memoriaUtilizada()
+{
+  long antes = ContadorDeMemoria::bytesEnUso();
+  unsigned long reservas = ContadorDeMemoria::reservas();
+  unsigned long liberaciones = ContadorDeMemoria::liberaciones();
+  {
+    PlanificadorRR<int> p;
+    size_t vacio = p.memoriaUtilizada();
+    for (int i = 0; i < 10; i++) {
+      p.agregarProceso(i);
+    }
+    ASSERT(p.memoriaUtilizada() > vacio);
+    ASSERT_EQ((int)(ContadorDeMemoria::reservas() - reservas), 10);
+    ASSERT(ContadorDeMemoria::bytesEnUso() > antes);
+    p.eliminarProceso(3);
+    ASSERT_EQ((int)(ContadorDeMemoria::liberaciones() - liberaciones), 1);
+  }
+  ASSERT_EQ((int)(ContadorDeMemoria::bytesEnUso() - antes), 0);
+
+  reservas = ContadorDeMemoria::reservas();
+  CartasEnlazadas<int, 4> m;
+  for (int i = 0; i < 4; i++) {
+    m.agregarJugador(i);
+  }
+  ASSERT_EQ((int)(ContadorDeMemoria::reservas() - reservas), 0);
+  size_t enElObjeto = m.memoriaUtilizada();
+  m.agregarJugador(4);
+  m.agregarJugador(5);
+  ASSERT_EQ((int)(ContadorDeMemoria::reservas() - reservas), 2);
+  ASSERT(m.memoriaUtilizada() > enElObjeto);
+  m.eliminarJugador(5);
+  m.eliminarJugador(4);
+  ASSERT_EQ((int)(ContadorDeMemoria::bytesEnUso() - antes), 0);
+}
+
+void plazosEDF()
+{
+  PlanificadorRR<int> p;
+  unsigned int g = p.crearGrupo();
+  p.agregarProceso(1);
+  p.agregarProceso(2);
+  p.agregarProceso(3, g);
+  p.agregarProceso(4, g);
+  p.agregarProceso(5);
+  ASSERT_EQ(to_s(p), "[1*, 2, 3, 4, 5]");
+  p.asignarPlazo(4, 30);
+  Manija seis = p.agregarProceso(6);
+  p.asignarPlazo(2, 20);
+  ASSERT_EQ(p.procesoEjecutado(), 2);
+  ASSERT_EQ(to_s(p), "[2*, 3, 4, 5, 6, 1]");
+  p.ejecutarSiguienteProceso();
+  ASSERT_EQ(p.procesoEjecutado(), 2);
+  p.pausarProceso(2);
+  ASSERT_EQ(p.procesoEjecutado(), 4);
+  p.asignarPlazo(seis, 10);
+  ASSERT_EQ(p.procesoEjecutado(), 6);
+  p.eliminarProceso(6);
+  p.pausarGrupo(g);
+  ASSERT_EQ(to_s(p), "[1*, 2 (i), 3 (i), 4 (i), 5]");
+  p.ejecutarSiguienteProceso();
+  ASSERT_EQ(p.procesoEjecutado(), 5);
+  p.reanudarProceso(2);
+  ASSERT_EQ(p.procesoEjecutado(), 2);
+  PlanificadorRR<int> copia(p);
+  ASSERT_EQ(copia.procesoEjecutado(), 2);
+  p.reanudarGrupo(g);
+  p.asignarPlazo(4, 5);
+  ASSERT_EQ(p.procesoEjecutado(), 4);
+  p.quitarPlazo(4);
+  p.quitarPlazo(2);
+  ASSERT(!p.tienePlazo(2));
+  ASSERT_EQ(to_s(p), "[5*, 1, 2, 3, 4]");
+}
+
+void borradoDiferido()
+{
+  long antes = ContadorDeMemoria::bytesEnUso();
+  {
+    PlanificadorRR<int> p;
+    PlanificadorRR<int> q;
+    p.diferirBorrado(true);
+    ASSERT(p.difiereBorrado());
+    Manija m;
+    for (int i = 0; i < 100; i++) {
+      Manija n = p.agregarProceso(i);
+      q.agregarProceso(i);
+      if (i == 95) {
+        m = n;
+      }
+    }
+    p.pausarProceso(97);
+    q.pausarProceso(97);
+    for (int i = 0; i < 52; i++) {
+      p.eliminarProceso(i);
+      q.eliminarProceso(i);
+    }
+    // recién ahora hay más lápidas que procesos
+    ASSERT(p.estaCompactando());
+    ASSERT(p.cantidadDeLapidas() >= 52);
+    ASSERT_EQ(to_s(p), to_s(q));
+    for (int i = 52; i < 90; i++) {
+      p.eliminarProceso(i);
+      q.eliminarProceso(i);
+    }
+    // los bloques viejos ya se devolvieron
+    ASSERT(!p.estaCompactando());
+    ASSERT(p.cantidadDeLapidas() < 38);
+    ASSERT_EQ(to_s(p), to_s(q));
+    ASSERT(p.esValida(m));
+    ASSERT(p.estaActivo(m));
+    p.pausarProceso(m);
+    ASSERT(!p.estaActivo(95));
+
+    PlanificadorRR<int> r;
+    r.unir(p);
+    ASSERT_EQ(p.cantidadDeProcesos(), 0);
+    ASSERT_EQ(r.cantidadDeProcesos(), q.cantidadDeProcesos());
+  }
+  ASSERT_EQ((int)(ContadorDeMemoria::bytesEnUso() - antes), 0);
+
+  {
+    CartasEnlazadas<int, 4> c;
+    CartasEnlazadas<int, 4> d;
+    c.diferirBorrado(true);
+    Manija m;
+    for (int i = 0; i < 60; i++) {
+      Manija n = c.agregarJugador(i);
+      d.agregarJugador(i);
+      if (i == 59) {
+        m = n;
+      }
+      c.sumarPuntosAlJugador(i, i);
+      d.sumarPuntosAlJugador(i, i);
+    }
+    c.adelantarMazoRojo(7);
+    d.adelantarMazoRojo(7);
+    for (int i = 0; i < 32; i++) {
+      c.eliminarJugador(i);
+      d.eliminarJugador(i);
+    }
+    ASSERT(c.estaCompactando());
+    for (int i = 60; i < 70 && c.estaCompactando(); i++) {
+      c.agregarJugador(i);
+      d.agregarJugador(i);
+    }
+    ASSERT(!c.estaCompactando());
+    ASSERT_EQ(to_s(c), to_s(d));
+    ASSERT_EQ(c.puntosDelJugador(m), 59);
+    ASSERT_EQ(c.dameJugadorConMazoRojo(), d.dameJugadorConMazoRojo());
+  }
+  ASSERT_EQ((int)(ContadorDeMemoria::bytesEnUso() - antes), 0);
+}
+
+/**
+ * Proceso "pesado" que se busca por id o por nombre. Cuenta sus copias.
+ */
+struct Descriptor {
+  int id;
+  string nombre;
+  static int copias;
+  Descriptor(int i, const string& n) : id(i), nombre(n) {}
+  Descriptor(const Descriptor& d) : id(d.id), nombre(d.nombre) { copias++; }
+  bool operator==(const Descriptor& d) const { return id == d.id; }
+  bool operator==(int i) const { return id == i; }
+  bool operator==(const char* n) const { return nombre == n; }
+};
+int Descriptor::copias = 0;
+
+ostream& operator<<(ostream& os, const Descriptor& d) {
+  return os << d.nombre;
+}
+
+void busquedaPorClave()
+{
+  PlanificadorRR<Descriptor> p;
+  p.agregarProceso(Descriptor(1, "init"));
+  Manija shell = p.agregarProceso(Descriptor(2, "shell"));
+  Manija cron = p.agregarProceso(Descriptor(3, "cron"));
+  p.pausarProceso(shell);
+  p.asignarPlazo(cron, 10);
+  int copias = Descriptor::copias;
+  ASSERT(p.esPlanificado(2));
+  ASSERT(p.esPlanificado("cron"));
+  ASSERT(!p.esPlanificado(4));
+  ASSERT(!p.estaActivo(2));
+  ASSERT(p.estaActivo("init"));
+  ASSERT(p.tienePlazo(3));
+  ASSERT(!p.tienePlazo("shell"));
+  ASSERT_EQ(Descriptor::copias, copias);
+
+  CartasEnlazadas<Descriptor, 2> c;
+  c.agregarJugador(Descriptor(1, "ana"));
+  c.agregarJugador(Descriptor(2, "beto"));
+  c.agregarJugador(Descriptor(3, "caro"));
+  c.sumarPuntosAlJugador(Descriptor(2, "beto"), 5);
+  c.sumarPuntosAlJugador(Descriptor(3, "caro"), 2);
+  copias = Descriptor::copias;
+  ASSERT(c.existeJugador(3));
+  ASSERT(!c.existeJugador("dani"));
+  ASSERT_EQ(c.puntosDelJugador("beto"), 5);
+  ASSERT_EQ(c.puntosDelJugador(1), 0);
+  ASSERT_EQ((int)c.posicionDelJugador(3), 2);
+  ASSERT_EQ(Descriptor::copias, copias);
+
+  // las manijas y el propio T siguen usando sus versiones
+  PlanificadorRR<int> q;
+  Manija m = q.agregarProceso(7);
+  ASSERT(q.estaActivo(m));
+  ASSERT(q.esPlanificado(7));
+}
+
+void cartasPublicadas()
+{
+  long antes = ContadorDeMemoria::bytesEnUso();
+  {
+    CartasEnlazadas<int> inicial;
+    for (int i = 0; i < 8; i++) {
+      inicial.agregarJugador(i);
+    }
+    CartasPublicadas<int> pub(inicial, 4);
+    atomic<bool> fin(false);
+    atomic<int> errores(0);
+    vector<thread> lectores;
+    for (int h = 0; h < 3; h++) {
+      lectores.push_back(thread([&pub, &fin, &errores]() {
+        CartasPublicadas<int>::Lector lector(pub);
+        unsigned long ultima = 0;
+        while (!fin.load()) {
+          CartasPublicadas<int>::Lectura l(lector);
+          // el escritor le suma un punto a cada uno por versión
+          int puntos = l.puntosDelJugador(l.dameJugadorConMazoRojo());
+          if (l.version() < ultima || l.tamanio() != 8 || puntos != (int)l.version() - 1
+              || l.puntosDelJugador(l.dameJugadorEnfrentado()) != puntos) {
+            errores++;
+          }
+          ultima = l.version();
+        }
+      }));
+    }
+    for (int v = 0; v < 300; v++) {
+      for (int i = 0; i < 8; i++) {
+        pub.borrador().sumarPuntosAlJugador(i, 1);
+      }
+      pub.borrador().adelantarMazoRojo(3);
+      pub.publicar();
+    }
+    fin.store(true);
+    for (unsigned int h = 0; h < lectores.size(); h++) {
+      lectores[h].join();
+    }
+    ASSERT_EQ(errores.load(), 0);
+    ASSERT_EQ((int)pub.versionPublicada(), 301);
+    pub.publicar();
+    ASSERT_EQ((int)pub.versionesRetenidas(), 0);
+
+    {
+      CartasPublicadas<int>::Lector lector(pub);
+      CartasPublicadas<int>::Lectura l(lector);
+      pub.borrador().sumarPuntosAlJugador(5, 1);
+      pub.publicar();
+      // la lectura abierta sigue viendo su versión, que no se libera
+      ASSERT_EQ(l.puntosDelJugador(5), 300);
+      ASSERT_EQ((int)pub.versionesRetenidas(), 1);
+    }
+    pub.publicar();
+    ASSERT_EQ((int)pub.versionesRetenidas(), 0);
+    CartasPublicadas<int>::Lector lector(pub);
+    CartasPublicadas<int>::Lectura l(lector);
+    ASSERT_EQ(l.ganador(), 5);
+  }
+  ASSERT_EQ((int)(ContadorDeMemoria::bytesEnUso() - antes), 0);
+}
+
+void planificadorFijo()
+{
+  PlanificadorRRFijo<int, 6> f;
+  PlanificadorRR<int> p;
+  ASSERT_EQ(to_s(f), to_s(p));
+  ASSERT_EQ((int)f.capacidad(), 6);
+  // la misma secuencia de operaciones da lo mismo en los dos
+  unsigned int azar = 7;
+  for (int paso = 0; paso < 300; paso++) {
+    azar = azar * 1103515245u + 12345u;
+    int proc = (azar >> 8) % 8;
+    int op = (azar >> 16) % 5;
+    if (op == 0 && !p.esPlanificado(proc)) {
+      if (f.agregarProceso(proc)) {
+        p.agregarProceso(proc);
+      } else {
+        ASSERT_EQ(p.cantidadDeProcesos(), 6);
+      }
+    } else if (op == 1 && p.esPlanificado(proc)) {
+      p.eliminarProceso(proc);
+      f.eliminarProceso(proc);
+    } else if (op == 2 && p.esPlanificado(proc)) {
+      p.pausarProceso(proc);
+      f.pausarProceso(proc);
+    } else if (op == 3 && p.esPlanificado(proc)) {
+      p.reanudarProceso(proc);
+      f.reanudarProceso(proc);
+    } else if (op == 4 && p.hayProcesosActivos()) {
+      p.ejecutarSiguienteProceso();
+      f.ejecutarSiguienteProceso();
+      ASSERT_EQ(f.procesoEjecutado(), p.procesoEjecutado());
+    }
+    ASSERT_EQ(to_s(f), to_s(p));
+    ASSERT_EQ(f.cantidadDeProcesosActivos(), p.cantidadDeProcesosActivos());
+  }
+
+  PlanificadorRRFijo<int, 3> lleno;
+  ASSERT(lleno.agregarProceso(1));
+  ASSERT(lleno.agregarProceso(2));
+  ASSERT(lleno.agregarProceso(3));
+  ASSERT(lleno.estaLleno());
+  ASSERT(!lleno.agregarProceso(4));
+  ASSERT_EQ(to_s(lleno), "[1*, 2, 3]");
+  lleno.pausarProceso(1);
+  PlanificadorRRFijo<int, 3> copia(lleno);
+  ASSERT(copia == lleno);
+  lleno.eliminarProceso(2);
+  ASSERT(lleno.agregarProceso(4));
+  ASSERT_EQ(to_s(lleno), "[3*, 1 (i), 4]");
+  ASSERT_EQ(to_s(copia), "[2*, 3, 1 (i)]");
+}
+
+void repartoProporcional()
+{
+  PlanificadorRR<int> p;
+  p.agregarProceso(1);
+  p.agregarProceso(2);
+  p.agregarProceso(3);
+  p.asignarBoletos(2, 2);
+  p.asignarBoletos(3, 7);
+  p.repartirPorZancadas();
+  ASSERT(p.reparto() == REPARTO_ZANCADAS);
+  int veces[4] = {0, 0, 0, 0};
+  for (int i = 0; i < 1000; i++) {
+    p.ejecutarSiguienteProceso();
+    veces[p.procesoEjecutado()]++;
+  }
+  // las zancadas reparten exacto, salvo el turno en curso
+  ASSERT(veces[1] >= 99 && veces[1] <= 101);
+  ASSERT(veces[2] >= 199 && veces[2] <= 201);
+  ASSERT(veces[3] >= 699 && veces[3] <= 701);
+
+  // un proceso pausado no recibe turnos y al volver no se los cobra
+  p.pausarProceso(3);
+  for (int i = 0; i < 30; i++) {
+    p.ejecutarSiguienteProceso();
+    ASSERT(p.procesoEjecutado() != 3);
+  }
+  p.reanudarProceso(3);
+  veces[1] = veces[2] = veces[3] = 0;
+  for (int i = 0; i < 100; i++) {
+    p.ejecutarSiguienteProceso();
+    veces[p.procesoEjecutado()]++;
+  }
+  ASSERT(veces[3] >= 69 && veces[3] <= 71);
+
+  PlanificadorRR<int> q;
+  unsigned int g = q.crearGrupo();
+  q.agregarProceso(1);
+  q.agregarProceso(2, g);
+  q.agregarProceso(3, g);
+  q.asignarBoletos(1, 3);
+  q.repartirPorLoteria(42);
+  PlanificadorRR<int> otro;
+  otro.agregarProceso(1);
+  otro.agregarProceso(2, otro.crearGrupo());
+  otro.agregarProceso(3, 1);
+  otro.asignarBoletos(1, 3);
+  otro.repartirPorLoteria(42);
+  int cuenta[4] = {0, 0, 0, 0};
+  for (int i = 0; i < 10000; i++) {
+    q.ejecutarSiguienteProceso();
+    otro.ejecutarSiguienteProceso();
+    cuenta[q.procesoEjecutado()]++;
+    // la misma semilla sortea lo mismo
+    ASSERT_EQ(q.procesoEjecutado(), otro.procesoEjecutado());
+  }
+  // 3/5, 1/5 y 1/5 de los sorteos
+  ASSERT(cuenta[1] > 5700 && cuenta[1] < 6300);
+  ASSERT(cuenta[2] > 1700 && cuenta[2] < 2300);
+  q.pausarGrupo(g);
+  for (int i = 0; i < 50; i++) {
+    q.ejecutarSiguienteProceso();
+    ASSERT_EQ(q.procesoEjecutado(), 1);
+  }
+  q.reanudarGrupo(g);
+  q.eliminarProceso(1);
+  for (int i = 0; i < 50; i++) {
+    q.ejecutarSiguienteProceso();
+    ASSERT(q.procesoEjecutado() != 1);
+  }
+  q.repartirPorRonda();
+  ASSERT_EQ((int)q.boletos(2), 1);
+}
+
+void canalDeCambios()
+{
+  {
+    // un hilo copia el planificador repitiendo los cambios que lee del canal
+    CanalDeCambios<int> canal(64);
+    ASSERT_EQ((int)canal.capacidad(), 64);
+    PlanificadorRR<int> p;
+    p.conectarCanal(&canal);
+    atomic<bool> fin(false);
+    atomic<int> errores(0);
+    string copia;
+    thread espejo([&canal, &fin, &errores, &copia]() {
+      PlanificadorRR<int> q;
+      bool terminar = false;
+      size_t leidos = 1;
+      while (!terminar || leidos != 0) {
+        terminar = fin.load();
+        leidos = canal.consumir([&q, &errores](const Cambio<int>& c) {
+          if (c.tipo == CAMBIO_AGREGAR) {
+            q.agregarProceso(c.sujeto());
+          } else if (c.tipo == CAMBIO_ELIMINAR) {
+            q.eliminarProceso(c.sujeto());
+          } else if (c.tipo == CAMBIO_PAUSAR) {
+            q.pausarProceso(c.sujeto());
+          } else if (c.tipo == CAMBIO_REANUDAR) {
+            q.reanudarProceso(c.sujeto());
+          } else if (c.tipo == CAMBIO_EJECUTAR) {
+            q.ejecutarSiguienteProceso();
+            if (!(q.procesoEjecutado() == c.sujeto())) {
+              errores++;
+            }
+          } else if (c.tipo == CAMBIO_DETENER) {
+            q.detener();
+          } else if (c.tipo == CAMBIO_REANUDAR_TODO) {
+            q.reanudar();
+          } else {
+            errores++;
+          }
+        }, 16);
+      }
+      copia = to_s(q);
+    });
+    for (int i = 0; i < 2000; i++) {
+      int n = i % 10;
+      if (!p.esPlanificado(n)) {
+        p.agregarProceso(n);
+      } else if (i % 7 == 0) {
+        p.eliminarProceso(n);
+      } else if (i % 3 == 0) {
+        if (p.estaActivo(n)) {
+          p.pausarProceso(n);
+        } else {
+          p.reanudarProceso(n);
+        }
+      }
+      if (p.hayProcesosActivos()) {
+        p.ejecutarSiguienteProceso();
+      }
+      if (i % 100 == 0) {
+        p.detener();
+        p.reanudar();
+      }
+      // sin perder cambios: se espera a que el espejo haga lugar
+      while (canal.pendientes() > canal.capacidad() - 4) {
+        this_thread::yield();
+      }
+    }
+    fin.store(true);
+    espejo.join();
+    ASSERT_EQ(errores.load(), 0);
+    ASSERT_EQ((int)canal.perdidos(), 0);
+    ASSERT_EQ(copia, to_s(p));
+  }
+
+  {
+    // con el canal lleno los cambios se pierden y se cuentan
+    CanalDeCambios<int> canal(3);
+    ASSERT_EQ((int)canal.capacidad(), 4);
+    CartasEnlazadas<int> c;
+    c.conectarCanal(&canal);
+    c.agregarJugador(1);
+    c.agregarJugador(2);
+    c.sumarPuntosAlJugador(2, 5);
+    c.adelantarMazoRojo(3);
+    c.eliminarJugador(1);
+    ASSERT_EQ((int)canal.perdidos(), 1);
+    // con la foto pendiente no se manda nada más
+    c.sumarPuntosAlJugador(2, 1);
+    ASSERT_EQ((int)canal.perdidos(), 1);
+    ASSERT(!c.actualizarCanal());
+    vector<int> tipos;
+    vector<long> valores;
+    ASSERT_EQ((int)canal.consumir([&tipos, &valores](const Cambio<int>& k) {
+      tipos.push_back(k.tipo);
+      valores.push_back(k.valor);
+    }, 10), 4);
+    ASSERT_EQ(tipos[2], (int)CAMBIO_PUNTOS);
+    ASSERT_EQ(valores[2], 5);
+    ASSERT_EQ(tipos[3], (int)CAMBIO_MAZO_ROJO);
+    ASSERT_EQ(valores[3], 3);
+
+    // cuando hay lugar el productor marca el hueco y manda la foto
+    ASSERT(c.actualizarCanal());
+    tipos.clear();
+    valores.clear();
+    ASSERT_EQ((int)canal.consumir([&tipos, &valores](const Cambio<int>& k) {
+      tipos.push_back(k.tipo);
+      valores.push_back(k.valor);
+    }, 10), 4);
+    ASSERT_EQ(tipos[0], (int)CAMBIO_RESINCRONIZAR);
+    ASSERT_EQ(valores[0], 1);
+    ASSERT_EQ(tipos[1], (int)CAMBIO_FOTO);
+    ASSERT_EQ(valores[1], 1);
+    ASSERT_EQ(tipos[2], (int)CAMBIO_AGREGAR);
+    ASSERT_EQ(tipos[3], (int)CAMBIO_PUNTOS);
+    ASSERT_EQ(valores[3], 6);
+    ASSERT(c.actualizarCanal());
+
+    // lo que no describe el canal manda otra foto, o la marca si no entra
+    c.agregarJugador(3);
+    c.agregarJugador(4);
+    c.sumarPuntosAlArcoDesdeMazoAzul(0, 1, 2);
+    c.conectarCanal(NULL);
+    c.agregarJugador(5);
+    tipos.clear();
+    ASSERT_EQ((int)canal.consumir([&tipos](const Cambio<int>& k) {
+      tipos.push_back(k.tipo);
+      ASSERT(k.tieneSujeto() == (k.tipo == CAMBIO_AGREGAR));
+    }, 10), 3);
+    ASSERT_EQ(tipos[1], (int)CAMBIO_AGREGAR);
+    ASSERT_EQ(tipos[2], (int)CAMBIO_RESINCRONIZAR);
+  }
+
+  {
+    // con un canal chico el espejo se pierde cambios pero siempre se recupera
+    CanalDeCambios<int> canalP(32);
+    CanalDeCambios<int> canalC(32);
+    PlanificadorRR<int> p;
+    CartasEnlazadas<int> c;
+    p.agregarProceso(100);
+    c.agregarJugador(100);
+    p.conectarCanal(&canalP);
+    c.conectarCanal(&canalC);
+    PlanificadorRR<int>* espejoP = new PlanificadorRR<int>();
+    CartasEnlazadas<int>* espejoC = new CartasEnlazadas<int>();
+    int fotos = 0;
+    int marcas = 0;
+    bool enHueco = false;
+    auto repetirP = [&espejoP, &fotos, &marcas, &enHueco](const Cambio<int>& k) {
+      if (k.tipo == CAMBIO_RESINCRONIZAR) {
+        // después de la marca sólo puede venir la foto
+        marcas++;
+        enHueco = true;
+      } else if (k.tipo == CAMBIO_FOTO) {
+        fotos++;
+        enHueco = false;
+        delete espejoP;
+        espejoP = new PlanificadorRR<int>();
+      } else {
+        ASSERT(!enHueco);
+        if (k.tipo == CAMBIO_AGREGAR) {
+          espejoP->agregarProceso(k.sujeto());
+        } else if (k.tipo == CAMBIO_ELIMINAR) {
+          espejoP->eliminarProceso(k.sujeto());
+        } else if (k.tipo == CAMBIO_PAUSAR) {
+          espejoP->pausarProceso(k.sujeto());
+        } else if (k.tipo == CAMBIO_REANUDAR) {
+          espejoP->reanudarProceso(k.sujeto());
+        } else if (k.tipo == CAMBIO_EJECUTAR) {
+          espejoP->ejecutarSiguienteProceso();
+          ASSERT(espejoP->procesoEjecutado() == k.sujeto());
+        } else if (k.tipo == CAMBIO_DETENER) {
+          espejoP->detener();
+        } else if (k.tipo == CAMBIO_REANUDAR_TODO) {
+          espejoP->reanudar();
+        }
+      }
+    };
+    auto repetirC = [&espejoC](const Cambio<int>& k) {
+      if (k.tipo == CAMBIO_FOTO) {
+        delete espejoC;
+        espejoC = new CartasEnlazadas<int>();
+      } else if (k.tipo == CAMBIO_AGREGAR) {
+        espejoC->agregarJugador(k.sujeto());
+      } else if (k.tipo == CAMBIO_ELIMINAR) {
+        espejoC->eliminarJugador(k.sujeto());
+      } else if (k.tipo == CAMBIO_PUNTOS) {
+        espejoC->sumarPuntosAlJugador(k.sujeto(), k.valor);
+      } else if (k.tipo == CAMBIO_MAZO_ROJO) {
+        espejoC->adelantarMazoRojo(k.valor);
+      } else if (k.tipo == CAMBIO_MAZO_AZUL) {
+        espejoC->adelantarMazoAzul(k.valor);
+      }
+    };
+    for (int i = 0; i < 3000; i++) {
+      int n = i % 13;
+      if (!p.esPlanificado(n)) {
+        p.agregarProceso(n);
+      } else if (i % 7 == 0) {
+        p.eliminarProceso(n);
+      } else if (i % 3 == 0) {
+        if (p.estaActivo(n)) {
+          p.pausarProceso(n);
+        } else {
+          p.reanudarProceso(n);
+        }
+      }
+      if (p.hayProcesosActivos()) {
+        p.ejecutarSiguienteProceso();
+      }
+      if (i % 50 == 0) {
+        p.detener();
+      } else if (i % 50 == 25) {
+        p.reanudar();
+      }
+      if (!c.existeJugador(n)) {
+        c.agregarJugador(n);
+      } else if (i % 5 == 0) {
+        c.eliminarJugador(n);
+      } else {
+        c.sumarPuntosAlJugador(n, i % 4);
+      }
+      c.adelantarMazoRojo(i % 3);
+      c.adelantarMazoAzul(i % 2);
+      if (i % 97 == 0) {
+        c.sumarPuntosAlArcoDesdeMazoAzul(0, 1, 1);
+      }
+      // el espejo lee a los saltos, así el canal se llena seguido
+      size_t lote = i % 40 == 0 ? 64 : (i % 3 == 0 ? 1 : 0);
+      canalP.consumir(repetirP, lote);
+      canalC.consumir(repetirC, lote);
+    }
+    ASSERT(canalP.perdidos() > 0);
+    ASSERT(canalC.perdidos() > 0);
+    ASSERT(fotos > 1);
+    ASSERT(marcas > 0);
+    // el productor se pone al día cuando el espejo termina de leer
+    while (!p.actualizarCanal() || !c.actualizarCanal() || canalP.pendientes() + canalC.pendientes() != 0) {
+      canalP.consumir(repetirP, 64);
+      canalC.consumir(repetirC, 64);
+    }
+    ASSERT_EQ(to_s(*espejoP), to_s(p));
+    ASSERT_EQ(to_s(*espejoC), to_s(c));
+    delete espejoP;
+    delete espejoC;
+  }
+
+  {
+    // los cambios de las cartas alcanzan para repetir el juego
+    CanalDeCambios<string> canal(256);
+    CartasEnlazadas<string> c;
+    CartasEnlazadas<string> espejo;
+    c.conectarCanal(&canal);
+    c.agregarJugador("a");
+    c.agregarJugador("b");
+    c.agregarJugador("c");
+    c.sumarPuntosAlJugador("b", 4);
+    c.adelantarMazoAzul(2);
+    c.adelantarMazoRojo(-1);
+    c.eliminarJugadorConMazoAzul();
+    c.agregarJugador("d");
+    c.sumarPuntosAlJugador("d", 1);
+    canal.consumir([&espejo](const Cambio<string>& k) {
+      if (k.tipo == CAMBIO_AGREGAR) {
+        espejo.agregarJugador(k.sujeto());
+      } else if (k.tipo == CAMBIO_ELIMINAR) {
+        espejo.eliminarJugador(k.sujeto());
+      } else if (k.tipo == CAMBIO_PUNTOS) {
+        espejo.sumarPuntosAlJugador(k.sujeto(), k.valor);
+      } else if (k.tipo == CAMBIO_MAZO_ROJO) {
+        espejo.adelantarMazoRojo(k.valor);
+      } else if (k.tipo == CAMBIO_MAZO_AZUL) {
+        espejo.adelantarMazoAzul(k.valor);
+      }
+    }, 256);
+    ASSERT_EQ(to_s(espejo), to_s(c));
+    // el canal se destruye con cambios sin leer
+    c.sumarPuntosAlJugador("d", 1);
+  }
+}
+
+void cambiosIncrementales()
+{
+  PlanificadorRR<int> p;
+  p.seguirCambios(true);
+  p.agregarProceso(1);
+  p.agregarProceso(2);
+  ostringstream os;
+  // al empezar hay que dibujar todo
+  p.mostrarCambios(os);
+  ASSERT_EQ(os.str(), "!\n");
+  os.str("");
+  p.mostrarCambios(os);
+  ASSERT_EQ(os.str(), "");
+
+  p.agregarProceso(3);
+  p.agregarProceso(4);
+  p.pausarProceso(1);
+  p.pausarProceso(3);
+  p.eliminarProceso(4);
+  p.reanudarProceso(3);
+  p.eliminarProceso(2);
+  p.mostrarCambios(os);
+  ASSERT_EQ(os.str(), "- 2\n+ 3\n~ 1 (i)\n* 3\n");
+  os.str("");
+  p.ejecutarSiguienteProceso();
+  p.mostrarCambios(os);
+  ASSERT_EQ(os.str(), "");
+  p.pausarProceso(3);
+  p.mostrarCambios(os);
+  ASSERT_EQ(os.str(), "~ 3 (i)\n* -\n");
+  os.str("");
+
+  // lo que no se describe por líneas pide redibujar
+  unsigned int g = p.crearGrupo();
+  p.agregarProceso(5, g);
+  p.pausarGrupo(g);
+  p.mostrarCambios(os);
+  ASSERT_EQ(os.str(), "!\n");
+  os.str("");
+
+  // juntando las páginas queda lo mismo que mostrarPlanificadorRR
+  for (int i = 10; i < 30; i++) {
+    p.agregarProceso(i);
+  }
+  string paginas;
+  Manija m = MANIJA_INVALIDA;
+  int cantidad = 0;
+  do {
+    ostringstream pagina;
+    m = p.mostrarPagina(pagina, m, 7);
+    string s = pagina.str();
+    paginas += (paginas.empty() ? "" : ", ") + s.substr(1, s.size() - 2);
+    cantidad++;
+  } while (m != MANIJA_INVALIDA);
+  ASSERT_EQ(cantidad, 4);
+  ASSERT_EQ("[" + paginas + "]", to_s(p));
+
+  // muchos cambios juntos también piden redibujar
+  p.mostrarCambios(os);
+  os.str("");
+  for (int i = 0; i < 100; i++) {
+    p.agregarProceso(100);
+    p.eliminarProceso(100);
+  }
+  p.mostrarCambios(os);
+  ASSERT_EQ(os.str(), "!\n");
+
+  CartasEnlazadas<int> c;
+  c.agregarJugador(1);
+  c.seguirCambios(true);
+  os.str("");
+  c.mostrarCambios(os);
+  ASSERT_EQ(os.str(), "!\n");
+  c.agregarJugador(2);
+  c.agregarJugador(3);
+  c.sumarPuntosAlJugador(1, 4);
+  c.sumarPuntosAlJugador(3, 2);
+  c.adelantarMazoRojo(1);
+  os.str("");
+  c.mostrarCambios(os);
+  ASSERT_EQ(os.str(), "+ (2,0)\n+ (3,2)\n~ (1,4)\nR 3\n");
+  c.eliminarJugador(1);
+  c.sumarPuntosAlJugador(2, 1);
+  os.str("");
+  c.mostrarCambios(os);
+  ASSERT_EQ(os.str(), "- 1\n~ (2,1)\nA 3\n");
+  os.str("");
+  c.sumarPuntosAlArcoDesdeMazoAzul(0, 2, 1);
+  c.mostrarCambios(os);
+  ASSERT_EQ(os.str(), "!\n");
+  c.agregarJugador(4);
+  ostringstream pagina;
+  Manija siguiente = c.mostrarPagina(pagina, MANIJA_INVALIDA, 2);
+  pagina << "|";
+  ASSERT(c.mostrarPagina(pagina, siguiente, 2) == MANIJA_INVALIDA);
+  ASSERT_EQ(to_s(c), "[(3,3)*,(4,0),(2,2)]");
+  ASSERT_EQ(pagina.str(), "[(3,3)*,(4,0)]|[(2,2)]");
+}
+
+void baldesDeFichas()
+{
+  PlanificadorRR<int> p;
+  p.agregarProceso(1);
+  p.limitarEjecuciones(1, 1, 3);
+  p.ejecutarSiguienteProceso();
+  ASSERT_EQ(to_s(p), "[1*]");
+  ASSERT(!p.estaFrenado(1));
+  // se ejecutó con su última ficha: al siguiente tic queda frenado
+  p.seguirCambios(true);
+  ostringstream os;
+  p.mostrarCambios(os);
+  os.str("");
+  p.ejecutarSiguienteProceso();
+  ASSERT(p.estaFrenado(1));
+  ASSERT(!p.estaActivo(1));
+  ASSERT(!p.hayProcesosActivos());
+  ASSERT_EQ(to_s(p), "[1 (f)]");
+  p.mostrarCambios(os);
+  ASSERT_EQ(os.str(), "~ 1 (f)\n* -\n");
+  ASSERT_EQ((int)p.reloj(), 2);
+  p.avanzarReloj(1);
+  ASSERT(p.estaFrenado(1));
+  p.avanzarReloj(1);
+  ASSERT_EQ(to_s(p), "[1*]");
+
+  // pausar y frenar son independientes; pausado se muestra como pausado
+  p.ejecutarSiguienteProceso();
+  p.ejecutarSiguienteProceso();
+  ASSERT(p.estaFrenado(1));
+  p.pausarProceso(1);
+  ASSERT_EQ(to_s(p), "[1 (i)]");
+  p.avanzarReloj(10);
+  ASSERT(!p.estaFrenado(1));
+  ASSERT_EQ(to_s(p), "[1 (i)]");
+  p.reanudarProceso(1);
+
+  p.agregarProceso(2);
+  p.agregarProceso(3);
+  p.limitarEjecuciones(1, 1, 4);
+  int veces[4] = {0, 0, 0, 0};
+  for (int i = 0; i < 1000; i++) {
+    p.ejecutarSiguienteProceso();
+    veces[p.procesoEjecutado()]++;
+  }
+  // una ficha cada 4 tics como mucho; los demás se reparten el resto
+  ASSERT(veces[1] <= 251 && veces[1] >= 150);
+  ASSERT_EQ(veces[1] + veces[2] + veces[3], 1000);
+  ASSERT(veces[2] >= veces[1] && veces[3] >= veces[1]);
+
+  // la copia sigue frenando y liberando igual
+  while (!p.estaFrenado(1)) {
+    p.ejecutarSiguienteProceso();
+  }
+  ASSERT(to_s(p).find("1 (f)") != string::npos);
+  PlanificadorRR<int> q(p);
+  ASSERT_EQ(to_s(q), to_s(p));
+  q.avanzarReloj(4);
+  p.avanzarReloj(4);
+  ASSERT(!q.estaFrenado(1));
+  ASSERT_EQ(to_s(q), to_s(p));
+
+  // con capacidad el balde aguanta ráfagas
+  PlanificadorRR<int> r;
+  r.agregarProceso(7);
+  r.limitarEjecuciones(7, 3, 10);
+  int seguidas = 0;
+  while (r.hayProcesosActivos()) {
+    r.ejecutarSiguienteProceso();
+    seguidas++;
+  }
+  ASSERT_EQ(seguidas, 4);
+  r.quitarLimite(7);
+  ASSERT_EQ(to_s(r), "[7*]");
+}
 
+void cursoresConNombre()
+{
+  CartasEnlazadas<int> c;
+  Nat sinMesa = c.crearCursor("turno");
+  c.agregarJugador(1);
+  ASSERT_EQ(c.jugadorConCursor(sinMesa), 1);
+  for (int i = 2; i <= 5; i++) {
+    c.agregarJugador(i);
+  }
+  Nat dealer = c.crearCursor("dealer");
+  ASSERT_EQ((int)c.cantidadDeCursores(), 2);
+  ASSERT_EQ((int)c.cursor("dealer"), (int)dealer);
+  ASSERT_EQ(c.nombreDelCursor(dealer), "dealer");
+  ASSERT_EQ(c.jugadorConCursor(dealer), c.dameJugadorConMazoAzul());
+
+  // moverse es relativo a la ronda, como los mazos
+  int azul = c.dameJugadorConMazoAzul();
+  c.adelantarMazoAzul(2);
+  int dosMas = c.dameJugadorConMazoAzul();
+  c.moverCursor(dealer, 2 + 5 * 1000);
+  ASSERT_EQ(c.jugadorConCursor(dealer), dosMas);
+  c.moverCursor(dealer, -2);
+  ASSERT_EQ(c.jugadorConCursor(dealer), azul);
+  c.ponerCursor(dealer, 3);
+  ASSERT_EQ(c.jugadorConCursor(dealer), 3);
+  ASSERT_EQ((int)c.cursoresDelJugador(3).size(), 1);
+
+  // si se va el jugador, sus cursores pasan al que seguía
+  c.ponerCursor(sinMesa, 3);
+  c.ponerCursor(dealer, 3);
+  c.moverCursor(dealer, 1);
+  int siguiente = c.jugadorConCursor(dealer);
+  c.moverCursor(dealer, -1);
+  c.eliminarJugador(3);
+  ASSERT_EQ(c.jugadorConCursor(dealer), siguiente);
+  ASSERT_EQ(c.jugadorConCursor(sinMesa), siguiente);
+  ASSERT_EQ((int)c.cursoresDelJugador(siguiente).size(), 2);
+
+  // la copia conserva los cursores
+  CartasEnlazadas<int> copia(c);
+  ASSERT(copia.existeCursor("dealer"));
+  ASSERT_EQ(copia.jugadorConCursor(copia.cursor("dealer")), siguiente);
+  copia.moverCursor(copia.cursor("turno"), 1);
+  ASSERT_EQ(c.jugadorConCursor(sinMesa), siguiente);
+
+  c.eliminarCursor(sinMesa);
+  ASSERT(!c.existeCursor("turno"));
+  ASSERT_EQ((int)c.cantidadDeCursores(), 1);
+  Nat otro = c.crearCursor("otro");
+  ASSERT_EQ((int)otro, (int)sinMesa);
+
+  // con la mesa vacía los cursores esperan al próximo jugador
+  c.moverCursor(dealer, 3);
+  while (!c.esVacia()) {
+    c.eliminarJugador(c.dameJugadorConMazoAzul());
+  }
+  c.agregarJugador(9);
+  ASSERT_EQ(c.jugadorConCursor(dealer), 9);
+  ASSERT_EQ(c.jugadorConCursor(otro), 9);
+  ASSERT_EQ((int)c.cursoresDelJugador(9).size(), 2);
+}
+
+void zancadasConservanElPase()
+{
+  PlanificadorRR<int> p;
+  unsigned int g = p.crearGrupo();
+  p.agregarProceso(1, g);
+  p.agregarProceso(2);
+  p.agregarProceso(3);
+  p.repartirPorZancadas();
+  p.pausarGrupo(g);
+  for (int i = 0; i < 1000; i++) {
+    p.ejecutarSiguienteProceso();
+  }
+  // al volver el grupo no recupera los turnos que no tuvo
+  p.reanudarGrupo(g);
+  int veces[4] = {0, 0, 0, 0};
+  for (int i = 0; i < 30; i++) {
+    p.ejecutarSiguienteProceso();
+    veces[p.procesoEjecutado()]++;
+  }
+  ASSERT(veces[1] >= 9 && veces[1] <= 11);
+
+  // cambiar boletos o plazo no le devuelve el turno al que recién se ejecutó
+  int ultimo = p.procesoEjecutado();
+  p.asignarBoletos(ultimo, 1);
+  p.ejecutarSiguienteProceso();
+  ASSERT(p.procesoEjecutado() != ultimo);
+  ultimo = p.procesoEjecutado();
+  p.asignarPlazo(ultimo, 5);
+  p.quitarPlazo(ultimo);
+  p.ejecutarSiguienteProceso();
+  ASSERT(p.procesoEjecutado() != ultimo);
+
+  // ni frenarlo: vuelve con el pase que tenía
+  p.limitarEjecuciones(2, 1, 3);
+  veces[1] = veces[2] = veces[3] = 0;
+  for (int i = 0; i < 300; i++) {
+    p.ejecutarSiguienteProceso();
+    veces[p.procesoEjecutado()]++;
+  }
+  ASSERT(veces[2] <= 101);
+  ASSERT(veces[1] >= 99 && veces[3] >= 99);
+  ASSERT_EQ(veces[1] + veces[2] + veces[3], 300);
+}
+
+void copiaDeZancadas()
+{
+  PlanificadorRR<int> p;
+  unsigned int g = p.crearGrupo();
+  p.agregarProceso(1);
+  p.agregarProceso(2);
+  p.agregarProceso(3);
+  p.agregarProceso(4, g);
+  p.agregarProceso(5, g);
+  p.asignarBoletos(1, 1);
+  p.asignarBoletos(2, 3);
+  p.asignarBoletos(3, 6);
+  p.asignarBoletos(5, 2);
+  p.repartirPorZancadas();
+  p.limitarEjecuciones(3, 2, 5);
+  for (int i = 0; i < 7; i++) {
+    p.ejecutarSiguienteProceso();
+  }
+  p.pausarGrupo(g);
+  for (int i = 0; i < 20; i++) {
+    p.ejecutarSiguienteProceso();
+  }
+  // la copia sigue eligiendo igual que el original, también con el grupo
+  // que vuelve de una pausa y con el que estaba frenado
+  PlanificadorRR<int> q(p);
+  for (int i = 0; i < 200; i++) {
+    if (i == 50) {
+      p.reanudarGrupo(g);
+      q.reanudarGrupo(g);
+    }
+    p.ejecutarSiguienteProceso();
+    q.ejecutarSiguienteProceso();
+    ASSERT_EQ(q.procesoEjecutado(), p.procesoEjecutado());
+  }
+}
+
+void transferirDesdeLaArena()
+{
+  // los procesos llegan igual si el origen los tenía en la arena o en el heap
+  vector<int> elegidos[2];
+  for (int d = 0; d < 2; d++) {
+    PlanificadorRR<int> o;
+    o.diferirBorrado(d == 1);
+    for (int i = 1; i <= 4; i++) {
+      o.agregarProceso(i);
+    }
+    o.asignarBoletos(2, 3);
+    o.limitarEjecuciones(3, 1, 4);
+    o.asignarPlazo(4, 9);
+    o.pausarProceso(1);
+    PlanificadorRR<int> q;
+    q.repartirPorZancadas();
+    q.agregarProceso(10);
+    q.transferirProcesos(o, 1, 4);
+    ASSERT(q.tienePlazo(4));
+    q.quitarPlazo(4);
+    q.reanudarProceso(1);
+    for (int i = 0; i < 40; i++) {
+      q.ejecutarSiguienteProceso();
+      elegidos[d].push_back(q.procesoEjecutado());
+    }
+    ASSERT_EQ((int)q.boletos(2), 3);
+  }
+  ASSERT(elegidos[0] == elegidos[1]);
+}
+
+void tamanioDeNodos()
+{
+  // cada proceso ocupa sus dos enlaces, la ranura con las marcas y el nombre;
+  // el estado de plazos, reparto, baldes y modo diferido no está en el nodo
+  long antes = ContadorDeMemoria::bytesEnUso();
+  PlanificadorRR<int> p;
+  for (int i = 0; i < 10; i++) {
+    p.agregarProceso(i);
+  }
+  p.asignarPlazo(3, 7);
+  p.asignarBoletos(4, 2);
+  p.limitarEjecuciones(5, 1, 3);
+  long porProceso = (ContadorDeMemoria::bytesEnUso() - antes) / 10;
+  ASSERT((size_t)porProceso <= 2 * sizeof(void*) + 2 * sizeof(int));
+
+  // la marca de cambios comparte palabra con la ranura y los cursores no
+  // están en el nodo
+  antes = ContadorDeMemoria::bytesEnUso();
+  CartasEnlazadas<int> c;
+  for (int i = 0; i < 10; i++) {
+    c.agregarJugador(i);
+  }
+  c.crearCursor("uno");
+  long porJugador = (ContadorDeMemoria::bytesEnUso() - antes) / 10;
+  ASSERT((size_t)porJugador <= 2 * sizeof(void*) + 4 * sizeof(int));
+}
+
+void arcosYPosiciones()
+{
+  CartasEnlazadas<int> m;
+  for (int i = 0; i < 40; i++) {
+    m.agregarJugador(i);
+    m.sumarPuntosAlJugador(i, i % 7);
+  }
+  ASSERT_EQ((int)m.posicionDelJugador(6), 1);
+  ASSERT_EQ((int)m.armadosDelIndice(), 1);
+  // los arcos cortos corrigen la tabla sin volver a armarla
+  for (int k = 0; k < 30; k++) {
+    m.sumarPuntosAlArcoDesdeMazoAzul(k * 3 - 20, 1 + k % 10, k % 4 - 1);
+    for (int j = 0; j < 40; j += 13) {
+      int mejores = 1;
+      for (int i = 0; i < 40; i++) {
+        if (m.puntosDelJugador(i) > m.puntosDelJugador(j)) {
+          mejores++;
+        }
+      }
+      ASSERT_EQ((int)m.posicionDelJugador(j), mejores);
+    }
+  }
+  ASSERT_EQ((int)m.armadosDelIndice(), 1);
+  // uno que abarca más de la cuarta parte la deja para la próxima consulta
+  m.sumarPuntosAlArcoDesdeMazoAzul(0, 11, 5);
+  ASSERT_EQ((int)m.armadosDelIndice(), 1);
+  m.ganador();
+  ASSERT_EQ((int)m.armadosDelIndice(), 2);
+}
+
+#if defined(__cpp_impl_coroutine)
+Tarea anotar(vector<int>& registro, int id, int veces)
+{
+  for (int i = 0; i < veces; i++) {
+    registro.push_back(id);
+    co_await ceder();
+  }
+}
+
+Tarea dormilona(vector<int>& registro, int id)
+{
+  registro.push_back(id);
+  co_await dormir(5);
+  registro.push_back(id);
+}
+
+Tarea esperarEvento(vector<int>& registro, Evento& e, int id)
+{
+  co_await esperar(e);
+  registro.push_back(id);
+}
+
+void ejecutorCorrutinas()
+{
+  EjecutorRR ej;
+  Evento listo(ej);
+  vector<int> registro;
+  ej.lanzar(anotar(registro, 1, 3));
+  ej.lanzar(anotar(registro, 2, 2));
+  ej.lanzar(dormilona(registro, 3));
+  ej.lanzar(esperarEvento(registro, listo, 4));
+  ASSERT_EQ(ej.cantidadDeTareas(), 4);
+  for (int i = 0; i < 4; i++) {
+    ej.ejecutarSiguiente();
+  }
+  ASSERT_EQ(listo.cantidadEsperando(), 1);
+  ASSERT_EQ(to_s(ej.planificador()), "[0*, 1, 2 (i), 3 (i)]");
+  listo.senalar();
+  ASSERT_EQ((int) ej.correr(), 7);
+  ASSERT_EQ((int) ej.tiempo(), 11);
+  ASSERT_EQ(ej.cantidadDeTareas(), 0);
+  int esperado[] = {1, 2, 3, 1, 2, 4, 1, 3};
+  ASSERT_EQ((int) registro.size(), 8);
+  for (int i = 0; i < 8; i++) {
+    ASSERT_EQ(registro[i], esperado[i]);
+  }
+}
+#endif
 
 int main()
 {
@@ -124,6 +1724,40 @@ int main()
   RUN_TEST( constructorPorCopia );
   RUN_TEST( testNombre );
   RUN_TEST( PlanifdePlanif );
+  RUN_TEST( iteradoresPlanificador );
+  RUN_TEST( iteradoresCartas );
+  RUN_TEST( mazosDiferidos );
+  RUN_TEST( mesaChica );
+  RUN_TEST( eliminarCadaK );
+  RUN_TEST( grupoRobaYBalancea );
+  RUN_TEST( grupoConHilos );
+  RUN_TEST( manijas );
+  RUN_TEST( empalmes );
+  RUN_TEST( gruposDeProcesos );
+  RUN_TEST( cambiosDiferidos );
+  RUN_TEST( tablaDePosiciones );
+  RUN_TEST( puntosPorArcos );
+  RUN_TEST( puntosEnLote );
+  RUN_TEST( simuladorTorneos );
+  RUN_TEST( memoriaUtilizada );
+  RUN_TEST( plazosEDF );
+  RUN_TEST( borradoDiferido );
+  RUN_TEST( busquedaPorClave );
+  RUN_TEST( cartasPublicadas );
+  RUN_TEST( planificadorFijo );
+  RUN_TEST( repartoProporcional );
+  RUN_TEST( canalDeCambios );
+  RUN_TEST( cambiosIncrementales );
+  RUN_TEST( baldesDeFichas );
+  RUN_TEST( cursoresConNombre );
+  RUN_TEST( zancadasConservanElPase );
+  RUN_TEST( copiaDeZancadas );
+  RUN_TEST( transferirDesdeLaArena );
+  RUN_TEST( tamanioDeNodos );
+  RUN_TEST( arcosYPosiciones );
+#if defined(__cpp_impl_coroutine)
+  RUN_TEST( ejecutorCorrutinas );
+#endif
 
   
   //RUN_TEST( DestroyPlanif );